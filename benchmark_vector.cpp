@@ -1,5 +1,29 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #ifdef TEST_STL_VECTOR
 #include <vector>
@@ -9,10 +33,54 @@ using vector = std::vector<T>;
 #include "deque"
 template <typename T>
 using vector = std::deque<T>;
+template <typename T>
+using queue = std::deque<T>;
 #elif TEST_CHUNK_VECTOR
+#include "chunk_algorithms.hpp"
+#include "chunk_channel.hpp"
+#include "chunk_ring.hpp"
+#include "chunk_soa_vector.hpp"
+#include "chunk_sort.hpp"
 #include "chunk_vector.hpp"
+#include "compressed_chunk_vector.hpp"
+#include "huge_page_allocator.hpp"
+#include "numa_allocator.hpp"
+#include "small_chunk_vector.hpp"
+#include "sorted_chunk_vector.hpp"
+#include "sparse_chunk_vector.hpp"
+#include "zoned_chunk_vector.hpp"
 template <typename T>
 using vector = CustomVector::chunk_vector<T>;
+template <typename T>
+using queue = CustomVector::chunk_ring<T>;
+template <typename T, std::size_t inline_capacity>
+using small_vector = CustomVector::small_chunk_vector<T, inline_capacity>;
+template <typename T>
+using adaptive_vector = CustomVector::
+    chunk_vector<T, 8192 / sizeof(T), std::allocator<T>, 4>;
+template <typename T>
+using inline_table_vector = CustomVector::chunk_vector<
+    T,
+    8192 / sizeof(T),
+    std::allocator<T>,
+    8192 / sizeof(T),
+    CustomVector::inline_chunk_table<64>>;
+// Room for 128 MiB of elements.
+template <typename T>
+using fixed_table_vector = CustomVector::chunk_vector<
+    T,
+    8192 / sizeof(T),
+    std::allocator<T>,
+    8192 / sizeof(T),
+    CustomVector::fixed_chunk_table<(128 << 20) / 8192>>;
+template <typename T>
+using huge_page_vector = CustomVector::chunk_vector<
+    T,
+    (sizeof(T) > 8192 ? 1 : 8192 / sizeof(T)),
+    CustomVector::huge_page_allocator<T>>;
+template <typename T>
+using numa_vector = CustomVector::
+    chunk_vector<T, 65536 / sizeof(T), CustomVector::numa_allocator<T>>;
 #endif
 
 namespace {
@@ -41,6 +109,13 @@ public:
         return value_;
     }
 
+    friend bool operator<(
+        const NonTriviallyCopyableInt &lhs,
+        const NonTriviallyCopyableInt &rhs
+    ) {
+        return lhs.value_ < rhs.value_;
+    }
+
 private:
     int value_;
 };
@@ -51,6 +126,22 @@ public:
     char data[size];
 };
 
+// 16-byte record ordered by its key.
+class Record {
+public:
+    std::int64_t key = 0;
+    std::int64_t payload = 0;
+
+    Record() = default;
+
+    Record(int key) : key(key), payload(key) {
+    }
+
+    friend bool operator<(const Record &lhs, const Record &rhs) {
+        return lhs.key < rhs.key;
+    }
+};
+
 template <std::size_t size>
 class NonTriviallyCopyableBigSizeClass {
 public:
@@ -88,6 +179,45 @@ public:
     ~NonTriviallyCopyableBigSizeClass() = default;
 };
 
+// A string behind a pointer. Unlike a libstdc++ std::string it never points
+// into itself, so its bytes can be moved to another address.
+class RelocatableString {
+public:
+    RelocatableString() : value_(std::make_unique<std::string>()) {
+    }
+
+    RelocatableString(const std::string &value)
+        : value_(std::make_unique<std::string>(value)) {
+    }
+
+    RelocatableString(const RelocatableString &other)
+        : value_(std::make_unique<std::string>(*other.value_)) {
+    }
+
+    RelocatableString &operator=(const RelocatableString &other) {
+        value_ = std::make_unique<std::string>(*other.value_);
+        return *this;
+    }
+
+    RelocatableString(RelocatableString &&) = default;
+
+    RelocatableString &operator=(RelocatableString &&) = default;
+
+    ~RelocatableString() = default;
+
+private:
+    std::unique_ptr<std::string> value_;
+};
+}  // namespace
+
+#ifdef TEST_CHUNK_VECTOR
+template <>
+struct CustomVector::is_trivially_relocatable<RelocatableString>
+    : std::true_type {};
+#endif
+
+namespace {
+
 template <typename T = int, std::size_t iterations = 1000>
 void push_back_BM(benchmark::State &state) {
     T obj = T();
@@ -143,88 +273,1971 @@ void random_access_BM(benchmark::State &state) {
     }
 }
 
-}  // namespace
+template <typename T>
+std::vector<T> random_values(std::size_t size) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist;
+    std::vector<T> values;
+    values.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        values.emplace_back(dist(gen));
+    }
+    return values;
+}
 
-static_assert(
-    sizeof(BigSizeClass<512>) == 512,
-    "BigSizeClass<512> size is incorrect"
-);
-static_assert(
-    sizeof(BigSizeClass<1024>) == 1024,
-    "BigSizeClass<1024> size is incorrect"
-);
-static_assert(
-    sizeof(NonTriviallyCopyableBigSizeClass<512>) == 512,
-    "NonTriviallyCopyableBigSizeClass<512> size is incorrect"
-);
-static_assert(
-    sizeof(NonTriviallyCopyableBigSizeClass<1024>) == 1024,
-    "NonTriviallyCopyableBigSizeClass<1024> size is incorrect"
-);
+template <typename T = int>
+void insert_middle_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    T obj = T();
+    vector<T> v(size);
 
-static_assert(
-    !std::is_trivially_copyable_v<NonTriviallyCopyableInt>,
-    "NonTriviallyCopyableInt should not be trivially copyable"
-);
-static_assert(
-    !std::is_trivially_copyable_v<NonTriviallyCopyableBigSizeClass<512>>,
-    "NonTriviallyCopyableBigSizeClass<512> should not be trivially copyable"
-);
-static_assert(
-    !std::is_trivially_copyable_v<NonTriviallyCopyableBigSizeClass<1024>>,
-    "NonTriviallyCopyableBigSizeClass<1024> should not be trivially copyable"
-);
+    for (auto _ : state) {
+        v.insert(v.begin() + v.size() / 2, obj);
+        if (v.size() == 2 * size) {
+            state.PauseTiming();
+            v.resize(size);
+            state.ResumeTiming();
+        }
+    }
+    benchmark::DoNotOptimize(v);
+}
 
-BENCHMARK(push_back_BM<int, 1000>);
-BENCHMARK(push_back_BM<NonTriviallyCopyableInt, 1000>);
-BENCHMARK(push_back_BM<int, 100000>);
-BENCHMARK(push_back_BM<NonTriviallyCopyableInt, 100000>);
+template <typename T = int>
+void erase_middle_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    vector<T> v(size);
 
-BENCHMARK(push_back_BM<BigSizeClass<512>, 1000>);
-BENCHMARK(push_back_BM<NonTriviallyCopyableBigSizeClass<512>, 1000>);
-BENCHMARK(push_back_BM<BigSizeClass<512>, 100000>);
-BENCHMARK(push_back_BM<NonTriviallyCopyableBigSizeClass<512>, 100000>);
+    for (auto _ : state) {
+        v.erase(v.begin() + v.size() / 2);
+        if (v.size() == size / 2) {
+            state.PauseTiming();
+            v.resize(size);
+            state.ResumeTiming();
+        }
+    }
+    benchmark::DoNotOptimize(v);
+}
 
-BENCHMARK(push_back_BM<BigSizeClass<1024>, 1000>);
-BENCHMARK(push_back_BM<NonTriviallyCopyableBigSizeClass<1024>, 1000>);
-BENCHMARK(push_back_BM<BigSizeClass<1024>, 100000>);
-BENCHMARK(push_back_BM<NonTriviallyCopyableBigSizeClass<1024>, 100000>);
+// Moves a vector into a new one through the allocator-extended move
+// constructor, which moves the elements one by one.
+template <typename T = int>
+void move_with_allocator_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    vector<T> v(size, T(std::string(32, 'x')));
 
-BENCHMARK(push_back_after_reserve_BM<int, 1000>);
-BENCHMARK(push_back_after_reserve_BM<NonTriviallyCopyableInt, 1000>);
-BENCHMARK(push_back_after_reserve_BM<int, 100000>);
-BENCHMARK(push_back_after_reserve_BM<NonTriviallyCopyableInt, 100000>);
+    for (auto _ : state) {
+        vector<T> moved(std::move(v), v.get_allocator());
+        benchmark::DoNotOptimize(moved);
+        v = std::move(moved);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
 
-BENCHMARK(push_back_after_reserve_BM<BigSizeClass<512>, 1000>);
-BENCHMARK(push_back_after_reserve_BM<
-          NonTriviallyCopyableBigSizeClass<512>,
-          1000>);
-BENCHMARK(push_back_after_reserve_BM<BigSizeClass<512>, 100000>);
-BENCHMARK(push_back_after_reserve_BM<
-          NonTriviallyCopyableBigSizeClass<512>,
-          100000>);
+template <typename T = int>
+void iterate_BM(benchmark::State &state) {
+    vector<T> v(static_cast<std::size_t>(state.range(0)));
 
-BENCHMARK(push_back_after_reserve_BM<BigSizeClass<1024>, 1000>);
-BENCHMARK(push_back_after_reserve_BM<
-          NonTriviallyCopyableBigSizeClass<1024>,
-          1000>);
-BENCHMARK(push_back_after_reserve_BM<BigSizeClass<1024>, 100000>);
-BENCHMARK(push_back_after_reserve_BM<
-          NonTriviallyCopyableBigSizeClass<1024>,
-          100000>);
+    for (auto _ : state) {
+        for (auto it = v.begin(); it != v.end(); ++it) {
+            benchmark::DoNotOptimize(*it);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
 
-BENCHMARK(access_BM<int, 1000>);
-BENCHMARK(access_BM<int, 100000>);
-BENCHMARK(access_BM<BigSizeClass<512>, 1000>);
-BENCHMARK(access_BM<BigSizeClass<512>, 100000>);
-BENCHMARK(access_BM<BigSizeClass<1024>, 1000>);
-BENCHMARK(access_BM<BigSizeClass<1024>, 100000>);
+template <typename T = int>
+void sort_BM(benchmark::State &state) {
+    const std::vector<T> source =
+        random_values<T>(static_cast<std::size_t>(state.range(0)));
+    vector<T> v(source.begin(), source.end());
 
-BENCHMARK(random_access_BM<int, 1000>);
-BENCHMARK(random_access_BM<int, 100000>);
-BENCHMARK(random_access_BM<BigSizeClass<512>, 1000>);
-BENCHMARK(random_access_BM<BigSizeClass<512>, 100000>);
-BENCHMARK(random_access_BM<BigSizeClass<1024>, 1000>);
-BENCHMARK(random_access_BM<BigSizeClass<1024>, 100000>);
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::copy(source.begin(), source.end(), v.begin());
+        state.ResumeTiming();
+        std::sort(v.begin(), v.end());
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void copy_BM(benchmark::State &state) {
+    vector<T> v(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        vector<T> copy(v);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void move_BM(benchmark::State &state) {
+    vector<T> v(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        vector<T> moved(std::move(v));
+        benchmark::DoNotOptimize(moved);
+        v = std::move(moved);
+    }
+}
+
+template <typename T = int>
+void resize_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        vector<T> v;
+        v.resize(size);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void assign_range_BM(benchmark::State &state) {
+    const std::vector<T> source(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        vector<T> v;
+        v.assign(source.begin(), source.end());
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Bytes of heap in use, 0 where it can not be measured.
+std::size_t heap_in_use() {
+#ifdef __GLIBC__
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// Builds many vectors of state.range(0) elements, reads them back and
+// destroys them; reports the heap plus object bytes each vector takes.
+template <typename Vector = vector<int>>
+void many_small_vectors_BM(benchmark::State &state) {
+    constexpr std::size_t count = 100000;
+    const auto size = static_cast<int>(state.range(0));
+    std::size_t bytes = 0;
+
+    for (auto _ : state) {
+        const std::size_t heap_before = heap_in_use();
+        std::vector<Vector> vectors(count);
+        for (Vector &v : vectors) {
+            for (int i = 0; i < size; ++i) {
+                v.push_back(i);
+            }
+        }
+        bytes = heap_in_use() - heap_before;
+        long long sum = 0;
+        for (const Vector &v : vectors) {
+            for (int i = 0; i < size; ++i) {
+                sum += v[i];
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.counters["bytes_per_vector"] = static_cast<double>(bytes) / count;
+}
+
+// Pushes about 1M elements into vectors of state.range(0) elements each;
+// reports the heap plus object bytes per element.
+template <typename Vector = vector<int>>
+void growing_vectors_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const std::size_t count = std::max<std::size_t>(1, (1 << 20) / size);
+    std::size_t bytes = 0;
+
+    for (auto _ : state) {
+        const std::size_t heap_before = heap_in_use();
+        std::vector<Vector> vectors(count);
+        for (Vector &v : vectors) {
+            for (std::size_t i = 0; i < size; ++i) {
+                v.push_back(static_cast<int>(i));
+            }
+        }
+        bytes = heap_in_use() - heap_before;
+        benchmark::DoNotOptimize(vectors.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count * size);
+    state.counters["bytes_per_element"] =
+        static_cast<double>(bytes) / (count * size);
+}
+
+template <typename T = int>
+void clear_refill_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    T obj = T();
+    vector<T> v(size);
+
+    for (auto _ : state) {
+        v.clear();
+        for (std::size_t i = 0; i < size; ++i) {
+            v.push_back(obj);
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void shrink_to_fit_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    vector<T> v;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        v.resize(size);
+        v.resize(size / 4);
+        state.ResumeTiming();
+        v.shrink_to_fit();
+        benchmark::DoNotOptimize(v);
+    }
+}
+
+// Hardware counters for the access pattern benchmarks. Opening the events
+// fails without perf permissions or inside most VMs; in that case the
+// benchmarks just run without the extra counters.
+class perf_counters {
+public:
+    perf_counters() {
+#ifdef __linux__
+        open_event(
+            "LLC_misses", PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+        );
+        open_event(
+            "dTLB_misses", PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+        );
+#endif
+    }
+
+    perf_counters(const perf_counters &) = delete;
+
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    ~perf_counters() {
+#ifdef __linux__
+        for (const event &e : events) {
+            close(e.fd);
+        }
+#endif
+    }
+
+    void start() {
+#ifdef __linux__
+        for (const event &e : events) {
+            ioctl(e.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(e.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Stops counting and reports every counter divided by `accesses`.
+    void stop(benchmark::State &state, double accesses) {
+#ifdef __linux__
+        for (const event &e : events) {
+            ioctl(e.fd, PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t value = 0;
+            if (read(e.fd, &value, sizeof value) == sizeof value &&
+                accesses > 0) {
+                state.counters[std::string(e.name) + "/access"] =
+                    static_cast<double>(value) / accesses;
+            }
+        }
+#else
+        (void)state;
+        (void)accesses;
+#endif
+    }
+
+private:
+#ifdef __linux__
+    struct event {
+        const char *name;
+        int fd;
+    };
+
+    std::vector<event> events;
+
+    void
+    open_event(const char *name, std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attr{};
+        attr.size = sizeof attr;
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd >= 0) {
+            events.push_back({name, static_cast<int>(fd)});
+        }
+    }
+#endif
+};
+
+// Reads one value out of an element so the access patterns below really
+// load from memory instead of just computing addresses.
+int load_value(int value) {
+    return value;
+}
+
+template <std::size_t size>
+int load_value(const BigSizeClass<size> &value) {
+    return value.data[0];
+}
+
+std::vector<std::size_t> random_permutation(std::size_t size) {
+    std::vector<std::size_t> indices(size);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::shuffle(indices.begin(), indices.end(), std::mt19937_64(42));
+    return indices;
+}
+
+template <typename T = int, typename Vector = vector<T>>
+void permuted_access_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const std::vector<std::size_t> indices = random_permutation(size);
+    Vector v(size);
+    perf_counters counters;
+
+    counters.start();
+    for (auto _ : state) {
+        int sum = 0;
+        for (std::size_t index : indices) {
+            sum += load_value(v[index]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * size));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Visits every element once, jumping `stride` elements at a time and wrapping
+// around with a shifted start so the pattern still covers the whole vector.
+template <typename T = int>
+void strided_access_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto stride = static_cast<std::size_t>(state.range(1));
+    vector<T> v(size);
+    perf_counters counters;
+
+    counters.start();
+    for (auto _ : state) {
+        int sum = 0;
+        for (std::size_t start = 0; start < stride; ++start) {
+            for (std::size_t i = start; i < size; i += stride) {
+                sum += load_value(v[i]);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * size));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Every element stores the index of the next one, forming a single random
+// cycle (Sattolo's algorithm), so each load depends on the previous one and
+// neither the prefetcher nor out-of-order execution can hide the latency.
+template <typename Vector = vector<std::size_t>>
+void pointer_chase_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    std::vector<std::size_t> order(size);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 gen(42);
+    for (std::size_t i = size - 1; i > 0; --i) {
+        std::uniform_int_distribution<std::size_t> dist(0, i - 1);
+        std::swap(order[i], order[dist(gen)]);
+    }
+    Vector v(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        v[order[i]] = order[(i + 1) % size];
+    }
+    perf_counters counters;
+
+    counters.start();
+    std::size_t current = 0;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < size; ++i) {
+            current = v[current];
+        }
+        benchmark::DoNotOptimize(current);
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * size));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Random reads from state.range(0) vectors of 1 << 14 ints each, so every
+// read first has to find the chunk table of a vector that is likely not in
+// the cache.
+template <typename Vector = vector<int>>
+void many_vectors_access_BM(benchmark::State &state) {
+    constexpr std::size_t size = 1 << 14;
+    constexpr std::size_t reads = 1 << 20;
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::vector<Vector> vectors(count);
+    for (Vector &v : vectors) {
+        for (std::size_t i = 0; i < size; ++i) {
+            v.push_back(static_cast<int>(i));
+        }
+    }
+    std::mt19937_64 gen(42);
+    std::vector<std::pair<std::size_t, std::size_t>> positions(reads);
+    for (auto &[vector_index, index] : positions) {
+        vector_index = gen() % count;
+        index = gen() % size;
+    }
+
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto &[vector_index, index] : positions) {
+            sum += vectors[vector_index][index];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * reads);
+}
+
+template <typename T>
+vector<T> sequence(std::size_t size) {
+    vector<T> v;
+    for (std::size_t i = 0; i < size; ++i) {
+        v.push_back(static_cast<T>(i % 1000));
+    }
+    return v;
+}
+
+// Element by element algorithms through the container iterators; for
+// chunk_vector the same work is done per chunk by chunk_algorithms.hpp below.
+template <typename T = int>
+void sum_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), T()));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void min_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(*std::min_element(v.begin(), v.end()));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void count_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::count(v.begin(), v.end(), T(7)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void find_BM(benchmark::State &state) {
+    vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    v.back() = T(-1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::find(v.begin(), v.end(), T(-1)));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void equal_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    const vector<T> copy = v;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v == copy);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void less_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    vector<T> greater = v;
+    greater.back() += 1;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v < greater);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Concatenates 64 partial results of state.range(0) elements each.
+constexpr std::size_t concat_parts = 64;
+
+template <typename T>
+std::vector<vector<T>> partial_results(std::size_t part_size) {
+    std::vector<vector<T>> parts(concat_parts);
+    for (vector<T> &part : parts) {
+        for (std::size_t i = 0; i < part_size; ++i) {
+            part.push_back(T(static_cast<int>(i)));
+        }
+    }
+    return parts;
+}
+
+template <typename T = int>
+void concat_insert_BM(benchmark::State &state) {
+    const auto part_size = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<vector<T>> parts = partial_results<T>(part_size);
+        vector<T> result;
+        state.ResumeTiming();
+        for (vector<T> &part : parts) {
+            result.insert(
+                result.end(), std::make_move_iterator(part.begin()),
+                std::make_move_iterator(part.end())
+            );
+        }
+        benchmark::DoNotOptimize(result);
+        state.PauseTiming();
+        parts.clear();
+        result.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * concat_parts);
+}
+
+#ifndef TEST_STL_VECTOR
+// FIFO with a standing backlog of state.range(0) elements: a producer adds a
+// burst of state.range(1) elements, then a consumer takes as many.
+template <typename T = int>
+void queue_producer_consumer_BM(benchmark::State &state) {
+    const auto backlog = static_cast<std::size_t>(state.range(0));
+    const auto burst = static_cast<std::size_t>(state.range(1));
+    queue<T> q;
+    for (std::size_t i = 0; i < backlog; ++i) {
+        q.push_back(T(static_cast<int>(i)));
+    }
+
+    int next = 0;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < burst; ++i) {
+            q.push_back(T(next++));
+        }
+        for (std::size_t i = 0; i < burst; ++i) {
+            benchmark::DoNotOptimize(q.front());
+            q.pop_front();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+// A producer thread hands state.range(0) messages to the benchmark thread
+// through a mutex-protected queue, one lock per message on each side.
+template <typename T = int>
+void mutex_queue_messages_BM(benchmark::State &state) {
+    const auto messages = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        queue<T> q;
+        std::mutex mutex;
+        std::thread producer([&] {
+            for (int i = 0; i < messages; ++i) {
+                std::lock_guard<std::mutex> lock(mutex);
+                q.push_back(T(i));
+            }
+        });
+        for (int received = 0; received < messages;) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!q.empty()) {
+                benchmark::DoNotOptimize(q.front());
+                q.pop_front();
+                ++received;
+            }
+        }
+        producer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+#endif
+
+#ifdef TEST_CHUNK_VECTOR
+// Same workload as mutex_queue_messages_BM through a chunk_channel.
+template <typename T = int>
+void channel_messages_BM(benchmark::State &state) {
+    const auto messages = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        CustomVector::chunk_channel<T> channel;
+        std::thread producer([&] {
+            for (int i = 0; i < messages; ++i) {
+                channel.push(T(i));
+            }
+            channel.close();
+        });
+        while (channel.consume([](T *data, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                benchmark::DoNotOptimize(data[i]);
+            }
+        })) {
+        }
+        producer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void concat_append_BM(benchmark::State &state) {
+    const auto part_size = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<vector<T>> parts = partial_results<T>(part_size);
+        vector<T> result;
+        state.ResumeTiming();
+        for (vector<T> &part : parts) {
+            result.append(std::move(part));
+        }
+        benchmark::DoNotOptimize(result);
+        state.PauseTiming();
+        parts.clear();
+        result.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * concat_parts);
+}
+
+// Splits a vector into batches of state.range(0) elements.
+template <typename T = int>
+void split_batches_BM(benchmark::State &state) {
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    const std::size_t size = batch * concat_parts;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        vector<T> v = sequence<T>(size);
+        std::vector<vector<T>> batches;
+        state.ResumeTiming();
+        while (!v.empty()) {
+            batches.push_back(v.split_at(v.size() - batch));
+        }
+        benchmark::DoNotOptimize(batches);
+        state.PauseTiming();
+        batches.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// Same workload as sort_BM through CustomVector::sort; the second argument is
+// the number of threads.
+template <typename T = int>
+void chunk_sort_BM(benchmark::State &state) {
+    const std::vector<T> source =
+        random_values<T>(static_cast<std::size_t>(state.range(0)));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    vector<T> v(source.begin(), source.end());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::copy(source.begin(), source.end(), v.begin());
+        state.ResumeTiming();
+        CustomVector::sort(v, std::less<>(), threads);
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Same workload as sort_BM through CustomVector::radix_sort; records are
+// sorted by their key.
+template <typename T = int>
+void radix_sort_BM(benchmark::State &state) {
+    const std::vector<T> source =
+        random_values<T>(static_cast<std::size_t>(state.range(0)));
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    vector<T> v(source.begin(), source.end());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::copy(source.begin(), source.end(), v.begin());
+        state.ResumeTiming();
+        if constexpr (std::is_same_v<T, Record>) {
+            CustomVector::radix_sort(
+                v, [](const Record &r) { return r.key; }, threads
+            );
+        } else {
+            CustomVector::radix_sort(v, [](T x) { return x; }, threads);
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T = int>
+void compare_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    vector<T> greater = v;
+    greater.back() += 1;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(compare(v, greater));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, CustomVector::simd::level level>
+void simd_sum_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    CustomVector::simd::set_level(level);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CustomVector::sum(v));
+    }
+    CustomVector::simd::set_level(CustomVector::simd::level::avx2);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, CustomVector::simd::level level>
+void simd_min_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    CustomVector::simd::set_level(level);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CustomVector::min_value(v));
+    }
+    CustomVector::simd::set_level(CustomVector::simd::level::avx2);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, CustomVector::simd::level level>
+void simd_count_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    CustomVector::simd::set_level(level);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CustomVector::count(v, T(7)));
+    }
+    CustomVector::simd::set_level(CustomVector::simd::level::avx2);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, CustomVector::simd::level level>
+void simd_find_BM(benchmark::State &state) {
+    vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    v.back() = T(-1);
+    CustomVector::simd::set_level(level);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CustomVector::find(v, T(-1)));
+    }
+    CustomVector::simd::set_level(CustomVector::simd::level::avx2);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, CustomVector::simd::level level>
+void simd_equal_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    const vector<T> copy = v;
+    CustomVector::simd::set_level(level);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CustomVector::equal(v, copy));
+    }
+    CustomVector::simd::set_level(CustomVector::simd::level::avx2);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T, CustomVector::simd::level level>
+void simd_less_BM(benchmark::State &state) {
+    const vector<T> v = sequence<T>(static_cast<std::size_t>(state.range(0)));
+    vector<T> greater = v;
+    greater.back() += 1;
+    CustomVector::simd::set_level(level);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            CustomVector::lexicographical_compare(v, greater)
+        );
+    }
+    CustomVector::simd::set_level(CustomVector::simd::level::avx2);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+#endif
+
+// Wire format of a Record in a network batch: a 4-byte key followed by an
+// 8-byte payload, unaligned.
+constexpr std::size_t record_wire_size = 12;
+
+std::vector<unsigned char> encode_records(std::size_t count) {
+    std::vector<unsigned char> batch(count * record_wire_size);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto key = static_cast<std::int32_t>(i);
+        const auto payload = static_cast<std::int64_t>(i) * 3;
+        unsigned char *wire = batch.data() + i * record_wire_size;
+        std::memcpy(wire, &key, sizeof(key));
+        std::memcpy(wire + sizeof(key), &payload, sizeof(payload));
+    }
+    return batch;
+}
+
+Record decode_record(const unsigned char *wire) {
+    std::int32_t key;
+    std::memcpy(&key, wire, sizeof(key));
+    Record record(key);
+    std::memcpy(&record.payload, wire + sizeof(key), sizeof(record.payload));
+    return record;
+}
+
+// Decodes a batch of state.range(0) records into a new vector.
+void decode_push_back_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const std::vector<unsigned char> batch = encode_records(count);
+
+    for (auto _ : state) {
+        vector<Record> v;
+        for (std::size_t i = 0; i < count; ++i) {
+            v.push_back(decode_record(batch.data() + i * record_wire_size));
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * batch.size());
+}
+
+#ifdef TEST_CHUNK_VECTOR
+void decode_append_uninitialized_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const std::vector<unsigned char> batch = encode_records(count);
+
+    for (auto _ : state) {
+        vector<Record> v;
+        const unsigned char *wire = batch.data();
+        v.append_uninitialized(count, [&](Record *data, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                new (data + i) Record(decode_record(wire));
+                wire += record_wire_size;
+            }
+        });
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * batch.size());
+}
+
+void decode_grow_by_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const std::vector<unsigned char> batch = encode_records(count);
+
+    for (auto _ : state) {
+        vector<Record> v;
+        const unsigned char *wire = batch.data();
+        for (const auto &span : v.grow_by(count)) {
+            for (Record &record : span) {
+                record = decode_record(wire);
+                wire += record_wire_size;
+            }
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * batch.size());
+}
+
+template <typename T = int>
+void append_range_BM(benchmark::State &state) {
+    const std::vector<T> source = random_values<T>(state.range(0));
+
+    for (auto _ : state) {
+        vector<T> v;
+        v.append_range(source.begin(), source.end());
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+#endif
+
+template <typename T = int>
+void push_back_range_BM(benchmark::State &state) {
+    const std::vector<T> source = random_values<T>(state.range(0));
+
+    for (auto _ : state) {
+        vector<T> v;
+        for (const T &value : source) {
+            v.push_back(value);
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Parses state.range(0) whitespace-separated ints from a stream.
+void istream_assign_BM(benchmark::State &state) {
+    std::string text;
+    for (int value : random_values<int>(state.range(0))) {
+        text += std::to_string(value);
+        text += ' ';
+    }
+
+    for (auto _ : state) {
+        std::istringstream in(text);
+        vector<int> v;
+        v.assign(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+template <typename T = int>
+void list_assign_BM(benchmark::State &state) {
+    const std::vector<T> values = random_values<T>(state.range(0));
+    const std::list<T> source(values.begin(), values.end());
+
+    for (auto _ : state) {
+        vector<T> v;
+        v.assign(source.begin(), source.end());
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+std::string binary_ints(std::size_t count) {
+    const std::vector<int> values = random_values<int>(count);
+    return std::string(
+        reinterpret_cast<const char *>(values.data()), count * sizeof(int)
+    );
+}
+
+// Reads state.range(0) binary ints from a stream one by one.
+void binary_read_push_back_BM(benchmark::State &state) {
+    const std::string bytes = binary_ints(state.range(0));
+
+    for (auto _ : state) {
+        std::istringstream in(bytes);
+        vector<int> v;
+        int value;
+        while (in.read(reinterpret_cast<char *>(&value), sizeof(value))) {
+            v.push_back(value);
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+
+#ifdef TEST_CHUNK_VECTOR
+void read_from_BM(benchmark::State &state) {
+    const std::string bytes = binary_ints(state.range(0));
+
+    for (auto _ : state) {
+        std::istringstream in(bytes);
+        vector<int> v;
+        v.read_from(in, state.range(0));
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetBytesProcessed(state.iterations() * bytes.size());
+}
+#endif
+
+// Record with eight fields of which the scans below read one.
+struct WideRecord {
+    std::int64_t id;
+    double price;
+    int quantity;
+    int flags;
+    double a, b, c, d;
+};
+
+WideRecord wide_record(int i) {
+    return WideRecord{i, i * 0.5, i % 100, 0, 0.0, 0.0, 0.0, 0.0};
+}
+
+// Sums the quantity field of state.range(0) records stored as structures.
+void field_scan_aos_BM(benchmark::State &state) {
+    vector<WideRecord> v;
+    for (int i = 0; i < state.range(0); ++i) {
+        v.push_back(wide_record(i));
+    }
+
+    for (auto _ : state) {
+        long long total = 0;
+        for (const WideRecord &record : v) {
+            total += record.quantity;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#ifdef TEST_CHUNK_VECTOR
+using wide_soa_vector = CustomVector::chunk_soa_vector<std::tuple<
+    std::int64_t,
+    double,
+    int,
+    int,
+    double,
+    double,
+    double,
+    double>>;
+
+void field_scan_aos_chunks_BM(benchmark::State &state) {
+    vector<WideRecord> v;
+    for (int i = 0; i < state.range(0); ++i) {
+        v.push_back(wide_record(i));
+    }
+
+    for (auto _ : state) {
+        long long total = 0;
+        v.for_each_chunk(
+            0, v.chunk_count(),
+            [&total](const WideRecord *data, std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    total += data[i].quantity;
+                }
+            }
+        );
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void field_scan_soa_BM(benchmark::State &state) {
+    wide_soa_vector v;
+    for (int i = 0; i < state.range(0); ++i) {
+        const WideRecord r = wide_record(i);
+        v.emplace_back(r.id, r.price, r.quantity, r.flags, r.a, r.b, r.c, r.d);
+    }
+    const auto &quantities = v.column<2>();
+
+    for (auto _ : state) {
+        long long total = 0;
+        quantities.for_each_chunk(
+            0, quantities.chunk_count(),
+            [&total](const int *data, std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    total += data[i];
+                }
+            }
+        );
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void field_sum_soa_BM(benchmark::State &state) {
+    wide_soa_vector v;
+    for (int i = 0; i < state.range(0); ++i) {
+        const WideRecord r = wide_record(i);
+        v.emplace_back(r.id, r.price, r.quantity, r.flags, r.a, r.b, r.c, r.d);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(CustomVector::sum(v.column<2>()));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+#endif
+
+#ifdef TEST_CHUNK_VECTOR
+constexpr std::size_t timeline_size = 1 << 20;
+
+// Integer series of the kinds compressed_chunk_vector is meant for, chosen
+// by the benchmark argument: 0 - timestamps a jittered second apart,
+// 1 - readings in a narrow range, 2 - a status that changes rarely.
+std::int64_t timeline_value(int kind, std::size_t i, std::mt19937_64 &gen) {
+    switch (kind) {
+        case 0:
+            return 1'700'000'000'000 + static_cast<std::int64_t>(i) * 1000 +
+                   static_cast<std::int64_t>(gen() % 16);
+        case 1:
+            return 20'000 + static_cast<std::int64_t>(gen() % 1024);
+        default:
+            return static_cast<std::int64_t>(i / 5000 % 3);
+    }
+}
+
+template <typename Vector>
+void fill_timeline(Vector &v, int kind) {
+    std::mt19937_64 gen(42);
+    for (std::size_t i = 0; i < timeline_size; ++i) {
+        v.push_back(timeline_value(kind, i, gen));
+    }
+}
+
+void timeline_scan_BM(benchmark::State &state) {
+    CustomVector::chunk_vector<std::int64_t> v;
+    fill_timeline(v, static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        long long total = 0;
+        v.for_each_chunk(
+            0, v.chunk_count(),
+            [&total](const std::int64_t *data, std::size_t n) {
+                total += std::accumulate(data, data + n, 0LL);
+            }
+        );
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * timeline_size);
+    state.counters["bytes_per_element"] =
+        static_cast<double>(v.capacity() * sizeof(std::int64_t)) /
+        timeline_size;
+}
+
+void compressed_timeline_scan_BM(benchmark::State &state) {
+    CustomVector::compressed_chunk_vector<std::int64_t> v;
+    v.set_auto_seal(1);
+    fill_timeline(v, static_cast<int>(state.range(0)));
+
+    for (auto _ : state) {
+        long long total = 0;
+        v.for_each_chunk([&total](const std::int64_t *data, std::size_t n) {
+            total += std::accumulate(data, data + n, 0LL);
+        });
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * timeline_size);
+    state.counters["bytes_per_element"] =
+        static_cast<double>(v.memory_usage()) / timeline_size;
+}
+
+// Reads the last few thousand elements at random, as queries of recent
+// history do; they fall into a handful of sealed chunks.
+void compressed_timeline_recent_access_BM(benchmark::State &state) {
+    CustomVector::compressed_chunk_vector<std::int64_t> v;
+    fill_timeline(v, static_cast<int>(state.range(0)));
+    v.seal();
+    std::mt19937 gen(7);
+    std::vector<std::size_t> indices(4096);
+    for (std::size_t &index : indices) {
+        index = timeline_size - 1 - gen() % 3000;
+    }
+
+    for (auto _ : state) {
+        long long total = 0;
+        for (std::size_t index : indices) {
+            total += v[index];
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+#endif
+
+// Creates a value-initialized vector of state.range(0) ints and writes
+// 1024 of them at random.
+void resize_and_touch_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::mt19937_64 gen(3);
+    std::vector<std::size_t> positions(1024);
+    for (std::size_t &position : positions) {
+        position = gen() % count;
+    }
+
+    for (auto _ : state) {
+        vector<int> v;
+        v.resize(count);
+        for (std::size_t position : positions) {
+            v[position] = 1;
+        }
+        benchmark::DoNotOptimize(v);
+    }
+}
+
+#ifdef TEST_CHUNK_VECTOR
+void sparse_resize_and_touch_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::mt19937_64 gen(3);
+    std::vector<std::size_t> positions(1024);
+    for (std::size_t &position : positions) {
+        position = gen() % count;
+    }
+
+    std::size_t memory = 0;
+    for (auto _ : state) {
+        CustomVector::sparse_chunk_vector<int> v;
+        v.resize(count);
+        for (std::size_t position : positions) {
+            v.write(position) = 1;
+        }
+        memory = v.memory_usage();
+        benchmark::DoNotOptimize(v);
+    }
+    state.counters["megabytes"] = static_cast<double>(memory) / (1 << 20);
+}
+#endif
+
+// vector<bool> is the packed chunk_vector<bool> or std::vector<bool>; the
+// STL targets fall back to element loops where the word-level operations of
+// chunk_vector<bool> have no counterpart.
+vector<bool> random_bits(std::size_t size, unsigned one_in) {
+    std::mt19937 gen(5);
+    vector<bool> bits(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        bits[i] = gen() % one_in == 0;
+    }
+    return bits;
+}
+
+void bool_push_back_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        vector<bool> v;
+        for (std::size_t i = 0; i < count; ++i) {
+            v.push_back((i & 3) == 0);
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void bool_count_BM(benchmark::State &state) {
+    const vector<bool> v =
+        random_bits(static_cast<std::size_t>(state.range(0)), 2);
+    for (auto _ : state) {
+#ifdef TEST_CHUNK_VECTOR
+        benchmark::DoNotOptimize(v.count());
+#else
+        benchmark::DoNotOptimize(std::count(v.begin(), v.end(), true));
+#endif
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void bool_and_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    vector<bool> a = random_bits(count, 2);
+    const vector<bool> b = random_bits(count, 3);
+    for (auto _ : state) {
+#ifdef TEST_CHUNK_VECTOR
+        a &= b;
+#else
+        for (std::size_t i = 0; i < count; ++i) {
+            a[i] = a[i] && b[i];
+        }
+#endif
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Visits the set bits of a bitmap with one bit in 1000 set.
+void bool_find_iterate_BM(benchmark::State &state) {
+    const vector<bool> v =
+        random_bits(static_cast<std::size_t>(state.range(0)), 1000);
+    for (auto _ : state) {
+        std::size_t sum = 0;
+#ifdef TEST_CHUNK_VECTOR
+        for (auto i = v.find_first(); i != v.npos; i = v.find_next(i)) {
+            sum += i;
+        }
+#else
+        for (auto it = std::find(v.begin(), v.end(), true); it != v.end();
+             it = std::find(it + 1, v.end(), true)) {
+            sum += static_cast<std::size_t>(it - v.begin());
+        }
+#endif
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void bool_random_access_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const vector<bool> v = random_bits(count, 2);
+    std::mt19937_64 gen(7);
+    std::vector<std::size_t> positions(1 << 16);
+    for (std::size_t &position : positions) {
+        position = gen() % count;
+    }
+    for (auto _ : state) {
+        std::size_t set = 0;
+        for (std::size_t position : positions) {
+            set += v[position];
+        }
+        benchmark::DoNotOptimize(set);
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(positions.size())
+    );
+}
+
+// Range predicates over an almost sorted column, such as timestamps that
+// arrive slightly out of order; state.range(0) elements match.
+constexpr std::size_t range_scan_size = 1 << 24;
+
+int range_scan_value(std::size_t i) {
+    return static_cast<int>(i + i * 7919 % 1000);
+}
+
+void range_count_scan_BM(benchmark::State &state) {
+    vector<int> v;
+    for (std::size_t i = 0; i < range_scan_size; ++i) {
+        v.push_back(range_scan_value(i));
+    }
+    const int low = 1 << 23;
+    const int high = low + static_cast<int>(state.range(0)) - 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            std::count_if(v.begin(), v.end(), [low, high](int x) {
+                return low <= x && x <= high;
+            })
+        );
+    }
+}
+
+void range_find_scan_BM(benchmark::State &state) {
+    vector<int> v;
+    for (std::size_t i = 0; i < range_scan_size; ++i) {
+        v.push_back(range_scan_value(i));
+    }
+    const int low = static_cast<int>(range_scan_size) - 1000;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            std::find_if(v.begin(), v.end(), [low](int x) { return low <= x; })
+        );
+    }
+}
+
+#ifdef TEST_CHUNK_VECTOR
+void range_count_zoned_BM(benchmark::State &state) {
+    CustomVector::zoned_chunk_vector<int> v;
+    for (std::size_t i = 0; i < range_scan_size; ++i) {
+        v.push_back(range_scan_value(i));
+    }
+    const int low = 1 << 23;
+    const int high = low + static_cast<int>(state.range(0)) - 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v.count_in_range(low, high));
+    }
+}
+
+// Appends state.range(0) ints with 4-element chunks, one zone per chunk.
+void zoned_push_back_BM(benchmark::State &state) {
+    const auto n = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        CustomVector::zoned_chunk_vector<int, 4> v;
+        for (std::size_t i = 0; i < n; ++i) {
+            v.push_back(static_cast<int>(i));
+        }
+        benchmark::DoNotOptimize(v.size());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+void range_find_zoned_BM(benchmark::State &state) {
+    CustomVector::zoned_chunk_vector<int> v;
+    for (std::size_t i = 0; i < range_scan_size; ++i) {
+        v.push_back(range_scan_value(i));
+    }
+    const int low = static_cast<int>(range_scan_size) - 1000;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            v.find_in_range(low, std::numeric_limits<int>::max())
+        );
+    }
+}
+#endif
+
+// Lookups of random keys in a sorted vector of state.range(0) even numbers.
+std::vector<int> lookup_keys(std::size_t size) {
+    std::mt19937 gen(11);
+    std::vector<int> keys(1 << 16);
+    for (int &key : keys) {
+        key = static_cast<int>(gen() % (2 * size));
+    }
+    return keys;
+}
+
+void sorted_lower_bound_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    vector<int> v;
+    for (std::size_t i = 0; i < count; ++i) {
+        v.push_back(static_cast<int>(2 * i));
+    }
+    const std::vector<int> keys = lookup_keys(count);
+    for (auto _ : state) {
+        for (int key : keys) {
+            benchmark::DoNotOptimize(std::lower_bound(v.begin(), v.end(), key));
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(keys.size())
+    );
+}
+
+// Inserts state.range(0) random values, keeping the vector sorted.
+void ordered_insert_BM(benchmark::State &state) {
+    const std::vector<int> values = random_values<int>(state.range(0));
+    for (auto _ : state) {
+        vector<int> v;
+        for (int value : values) {
+            v.insert(std::upper_bound(v.begin(), v.end(), value), value);
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+#ifdef TEST_CHUNK_VECTOR
+void sorted_chunk_lower_bound_BM(benchmark::State &state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    CustomVector::sorted_chunk_vector<int> v;
+    for (std::size_t i = 0; i < count; ++i) {
+        v.insert(static_cast<int>(2 * i));
+    }
+    const std::vector<int> keys = lookup_keys(count);
+    for (auto _ : state) {
+        for (int key : keys) {
+            benchmark::DoNotOptimize(v.lower_bound(key));
+        }
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(keys.size())
+    );
+}
+
+void sorted_chunk_insert_BM(benchmark::State &state) {
+    const std::vector<int> values = random_values<int>(state.range(0));
+    for (auto _ : state) {
+        CustomVector::sorted_chunk_vector<int> v;
+        for (int value : values) {
+            v.insert(value);
+        }
+        benchmark::DoNotOptimize(v);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+#endif
+
+// Reads or writes the elements at 2^20 random indices of a vector of
+// state.range(0) ints, up to 1 GiB, like the probe side of a hash join.
+constexpr std::size_t gather_count = 1 << 20;
+
+vector<int> gather_source(std::size_t size) {
+    vector<int> v;
+    v.resize(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        v[i] = static_cast<int>(i);
+    }
+    return v;
+}
+
+std::vector<std::size_t> gather_indices(std::size_t size, bool sorted) {
+    std::mt19937_64 gen(13);
+    std::vector<std::size_t> indices(gather_count);
+    for (std::size_t &index : indices) {
+        index = gen() % size;
+    }
+    if (sorted) {
+        std::sort(indices.begin(), indices.end());
+    }
+    return indices;
+}
+
+// state.range(1) selects sorted indices.
+void naive_gather_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const vector<int> v = gather_source(size);
+    const std::vector<std::size_t> indices =
+        gather_indices(size, state.range(1) != 0);
+    std::vector<int> out(gather_count);
+    for (auto _ : state) {
+        for (std::size_t k = 0; k < gather_count; ++k) {
+            out[k] = v[indices[k]];
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(gather_count)
+    );
+}
+
+void naive_scatter_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    vector<int> v = gather_source(size);
+    const std::vector<std::size_t> indices = gather_indices(size, false);
+    const std::vector<int> values = random_values<int>(gather_count);
+    for (auto _ : state) {
+        for (std::size_t k = 0; k < gather_count; ++k) {
+            v[indices[k]] = values[k];
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(gather_count)
+    );
+}
+
+#ifdef TEST_CHUNK_VECTOR
+void gather_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const bool sorted = state.range(1) != 0;
+    const vector<int> v = gather_source(size);
+    const std::vector<std::size_t> indices = gather_indices(size, sorted);
+    std::vector<int> out(gather_count);
+    for (auto _ : state) {
+        if (sorted) {
+            v.gather(
+                CustomVector::sorted_indices, indices.begin(), indices.end(),
+                out.begin()
+            );
+        } else {
+            v.gather(indices.begin(), indices.end(), out.begin());
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(gather_count)
+    );
+}
+
+void scatter_BM(benchmark::State &state) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    vector<int> v = gather_source(size);
+    const std::vector<std::size_t> indices = gather_indices(size, false);
+    const std::vector<int> values = random_values<int>(gather_count);
+    for (auto _ : state) {
+        v.scatter(indices.begin(), indices.end(), values.begin());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(gather_count)
+    );
+}
+#endif
+
+#ifdef TEST_CHUNK_VECTOR
+constexpr std::size_t scan_size = 1 << 24;
+
+// Every benchmark thread sums its own contiguous range of chunks.
+template <typename Vector>
+void partitioned_scan(benchmark::State &state, const Vector &v) {
+    const std::size_t chunks = v.chunk_count();
+    const auto thread = static_cast<std::size_t>(state.thread_index());
+    const auto threads = static_cast<std::size_t>(state.threads());
+    const std::size_t first = chunks * thread / threads;
+    const std::size_t last = chunks * (thread + 1) / threads;
+
+    for (auto _ : state) {
+        long long sum = 0;
+        v.for_each_chunk(first, last, [&](const int *data, std::size_t size) {
+            for (std::size_t i = 0; i < size; ++i) {
+                sum += data[i];
+            }
+        });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(
+        state.iterations() * static_cast<std::int64_t>(scan_size / threads)
+    );
+}
+
+void partitioned_scan_BM(benchmark::State &state) {
+    static const vector<int> v(scan_size, 1);
+    partitioned_scan(state, v);
+}
+
+// With the blocked policy each node holds one contiguous slab of chunks, which
+// matches the contiguous per-thread ranges of partitioned_scan.
+template <CustomVector::numa_policy policy>
+void numa_partitioned_scan_BM(benchmark::State &state) {
+    static const numa_vector<int> v(
+        scan_size, 1,
+        CustomVector::numa_allocator<int>(
+            policy, scan_size / (65536 / sizeof(int)) /
+                        CustomVector::numa_node_count()
+        )
+    );
+    partitioned_scan(state, v);
+}
+#endif
+
+}  // namespace
+
+static_assert(
+    sizeof(BigSizeClass<512>) == 512,
+    "BigSizeClass<512> size is incorrect"
+);
+static_assert(
+    sizeof(BigSizeClass<1024>) == 1024,
+    "BigSizeClass<1024> size is incorrect"
+);
+static_assert(
+    sizeof(NonTriviallyCopyableBigSizeClass<512>) == 512,
+    "NonTriviallyCopyableBigSizeClass<512> size is incorrect"
+);
+static_assert(
+    sizeof(NonTriviallyCopyableBigSizeClass<1024>) == 1024,
+    "NonTriviallyCopyableBigSizeClass<1024> size is incorrect"
+);
+
+static_assert(
+    !std::is_trivially_copyable_v<NonTriviallyCopyableInt>,
+    "NonTriviallyCopyableInt should not be trivially copyable"
+);
+static_assert(
+    !std::is_trivially_copyable_v<NonTriviallyCopyableBigSizeClass<512>>,
+    "NonTriviallyCopyableBigSizeClass<512> should not be trivially copyable"
+);
+static_assert(
+    !std::is_trivially_copyable_v<NonTriviallyCopyableBigSizeClass<1024>>,
+    "NonTriviallyCopyableBigSizeClass<1024> should not be trivially copyable"
+);
+
+BENCHMARK(push_back_BM<int, 1000>);
+BENCHMARK(push_back_BM<NonTriviallyCopyableInt, 1000>);
+BENCHMARK(push_back_BM<int, 100000>);
+BENCHMARK(push_back_BM<NonTriviallyCopyableInt, 100000>);
+
+BENCHMARK(push_back_BM<BigSizeClass<512>, 1000>);
+BENCHMARK(push_back_BM<NonTriviallyCopyableBigSizeClass<512>, 1000>);
+BENCHMARK(push_back_BM<BigSizeClass<512>, 100000>);
+BENCHMARK(push_back_BM<NonTriviallyCopyableBigSizeClass<512>, 100000>);
+
+BENCHMARK(push_back_BM<BigSizeClass<1024>, 1000>);
+BENCHMARK(push_back_BM<NonTriviallyCopyableBigSizeClass<1024>, 1000>);
+BENCHMARK(push_back_BM<BigSizeClass<1024>, 100000>);
+BENCHMARK(push_back_BM<NonTriviallyCopyableBigSizeClass<1024>, 100000>);
+
+BENCHMARK(push_back_after_reserve_BM<int, 1000>);
+BENCHMARK(push_back_after_reserve_BM<NonTriviallyCopyableInt, 1000>);
+BENCHMARK(push_back_after_reserve_BM<int, 100000>);
+BENCHMARK(push_back_after_reserve_BM<NonTriviallyCopyableInt, 100000>);
+
+BENCHMARK(push_back_after_reserve_BM<BigSizeClass<512>, 1000>);
+BENCHMARK(push_back_after_reserve_BM<
+          NonTriviallyCopyableBigSizeClass<512>,
+          1000>);
+BENCHMARK(push_back_after_reserve_BM<BigSizeClass<512>, 100000>);
+BENCHMARK(push_back_after_reserve_BM<
+          NonTriviallyCopyableBigSizeClass<512>,
+          100000>);
+
+BENCHMARK(push_back_after_reserve_BM<BigSizeClass<1024>, 1000>);
+BENCHMARK(push_back_after_reserve_BM<
+          NonTriviallyCopyableBigSizeClass<1024>,
+          1000>);
+BENCHMARK(push_back_after_reserve_BM<BigSizeClass<1024>, 100000>);
+BENCHMARK(push_back_after_reserve_BM<
+          NonTriviallyCopyableBigSizeClass<1024>,
+          100000>);
+
+BENCHMARK(access_BM<int, 1000>);
+BENCHMARK(access_BM<int, 100000>);
+BENCHMARK(access_BM<BigSizeClass<512>, 1000>);
+BENCHMARK(access_BM<BigSizeClass<512>, 100000>);
+BENCHMARK(access_BM<BigSizeClass<1024>, 1000>);
+BENCHMARK(access_BM<BigSizeClass<1024>, 100000>);
+
+BENCHMARK(random_access_BM<int, 1000>);
+BENCHMARK(random_access_BM<int, 100000>);
+BENCHMARK(random_access_BM<BigSizeClass<512>, 1000>);
+BENCHMARK(random_access_BM<BigSizeClass<512>, 100000>);
+BENCHMARK(random_access_BM<BigSizeClass<1024>, 1000>);
+BENCHMARK(random_access_BM<BigSizeClass<1024>, 100000>);
+
+BENCHMARK(insert_middle_BM<int>)->Range(1 << 8, 1 << 16);
+BENCHMARK(insert_middle_BM<NonTriviallyCopyableInt>)->Range(1 << 8, 1 << 16);
+BENCHMARK(insert_middle_BM<BigSizeClass<512>>)->Range(1 << 8, 1 << 12);
+
+BENCHMARK(erase_middle_BM<int>)->Range(1 << 8, 1 << 16);
+BENCHMARK(erase_middle_BM<NonTriviallyCopyableInt>)->Range(1 << 8, 1 << 16);
+BENCHMARK(erase_middle_BM<BigSizeClass<512>>)->Range(1 << 8, 1 << 12);
+
+BENCHMARK(insert_middle_BM<std::string>)->Range(1 << 8, 1 << 16);
+BENCHMARK(insert_middle_BM<RelocatableString>)->Range(1 << 8, 1 << 16);
+BENCHMARK(erase_middle_BM<std::string>)->Range(1 << 8, 1 << 16);
+BENCHMARK(erase_middle_BM<RelocatableString>)->Range(1 << 8, 1 << 16);
+BENCHMARK(move_with_allocator_BM<std::string>)->Range(1 << 10, 1 << 20);
+BENCHMARK(move_with_allocator_BM<RelocatableString>)->Range(1 << 10, 1 << 20);
+
+BENCHMARK(iterate_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(iterate_BM<BigSizeClass<512>>)->Range(1 << 10, 1 << 16);
+
+BENCHMARK(sort_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(sort_BM<NonTriviallyCopyableInt>)->Range(1 << 10, 1 << 20);
+BENCHMARK(sort_BM<int>)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+BENCHMARK(sort_BM<Record>)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(copy_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(copy_BM<NonTriviallyCopyableInt>)->Range(1 << 10, 1 << 20);
+BENCHMARK(copy_BM<BigSizeClass<512>>)->Range(1 << 10, 1 << 16);
+
+BENCHMARK(move_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(move_BM<BigSizeClass<512>>)->Range(1 << 10, 1 << 16);
+
+BENCHMARK(resize_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(resize_BM<NonTriviallyCopyableInt>)->Range(1 << 10, 1 << 20);
+
+BENCHMARK(assign_range_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(assign_range_BM<NonTriviallyCopyableInt>)->Range(1 << 10, 1 << 20);
+
+BENCHMARK(clear_refill_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(clear_refill_BM<NonTriviallyCopyableInt>)->Range(1 << 10, 1 << 20);
+
+BENCHMARK(shrink_to_fit_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(shrink_to_fit_BM<BigSizeClass<512>>)->Range(1 << 10, 1 << 16);
+
+BENCHMARK(concat_insert_BM<int>)->Arg(8192)->Arg(8193)->Arg(65536);
+BENCHMARK(concat_insert_BM<NonTriviallyCopyableInt>)->Arg(8192)->Arg(8193);
+
+#ifndef TEST_STL_VECTOR
+BENCHMARK(queue_producer_consumer_BM<int>)
+    ->ArgsProduct({{0, 1 << 10, 1 << 20}, {1, 64, 4096}});
+BENCHMARK(queue_producer_consumer_BM<NonTriviallyCopyableInt>)
+    ->ArgsProduct({{1 << 10}, {64}});
+BENCHMARK(queue_producer_consumer_BM<Record>)
+    ->ArgsProduct({{1 << 10}, {64}});
+
+BENCHMARK(mutex_queue_messages_BM<int>)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(mutex_queue_messages_BM<Record>)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+#endif
+
+BENCHMARK(many_small_vectors_BM<>)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(many_small_vectors_BM<small_vector<int, 16>>)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64);
+#endif
+
+BENCHMARK(growing_vectors_BM<>)->RangeMultiplier(10)->Range(1, 100000);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(growing_vectors_BM<adaptive_vector<int>>)
+    ->RangeMultiplier(10)
+    ->Range(1, 100000);
+#endif
+
+BENCHMARK(decode_push_back_BM)->Range(1 << 10, 1 << 20);
+BENCHMARK(push_back_range_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(push_back_range_BM<NonTriviallyCopyableInt>)->Range(1 << 10, 1 << 20);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(decode_append_uninitialized_BM)->Range(1 << 10, 1 << 20);
+BENCHMARK(decode_grow_by_BM)->Range(1 << 10, 1 << 20);
+BENCHMARK(append_range_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(append_range_BM<NonTriviallyCopyableInt>)->Range(1 << 10, 1 << 20);
+#endif
+
+BENCHMARK(istream_assign_BM)->Range(1 << 10, 1 << 20);
+BENCHMARK(list_assign_BM<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK(list_assign_BM<NonTriviallyCopyableInt>)->Range(1 << 10, 1 << 20);
+BENCHMARK(binary_read_push_back_BM)->Range(1 << 10, 1 << 20);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(read_from_BM)->Range(1 << 10, 1 << 20);
+#endif
+
+BENCHMARK(field_scan_aos_BM)->Range(1 << 12, 1 << 20);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(field_scan_aos_chunks_BM)->Range(1 << 12, 1 << 20);
+BENCHMARK(field_scan_soa_BM)->Range(1 << 12, 1 << 20);
+BENCHMARK(field_sum_soa_BM)->Range(1 << 12, 1 << 20);
+
+BENCHMARK(timeline_scan_BM)->DenseRange(0, 2);
+BENCHMARK(compressed_timeline_scan_BM)->DenseRange(0, 2);
+BENCHMARK(compressed_timeline_recent_access_BM)->DenseRange(0, 2);
+#endif
+
+BENCHMARK(resize_and_touch_BM)->RangeMultiplier(16)->Range(1 << 16, 1 << 24);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(sparse_resize_and_touch_BM)
+    ->RangeMultiplier(16)
+    ->Range(1 << 16, 1 << 30);
+#endif
+
+BENCHMARK(bool_push_back_BM)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(bool_count_BM)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(bool_and_BM)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(bool_find_iterate_BM)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(bool_random_access_BM)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+
+BENCHMARK(range_count_scan_BM)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(range_find_scan_BM);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(range_count_zoned_BM)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(range_find_zoned_BM);
+BENCHMARK(zoned_push_back_BM)
+    ->RangeMultiplier(4)
+    ->Range(1 << 12, 1 << 20)
+    ->Complexity(benchmark::oN);
+#endif
+
+BENCHMARK(sorted_lower_bound_BM)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(ordered_insert_BM)->RangeMultiplier(4)->Range(1 << 10, 1 << 16);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(sorted_chunk_lower_bound_BM)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24);
+BENCHMARK(sorted_chunk_insert_BM)->RangeMultiplier(4)->Range(1 << 10, 1 << 16);
+#endif
+
+BENCHMARK(naive_gather_BM)
+    ->ArgsProduct({{1 << 16, 1 << 22, 1 << 28}, {0, 1}});
+BENCHMARK(naive_scatter_BM)->RangeMultiplier(64)->Range(1 << 16, 1 << 28);
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(gather_BM)->ArgsProduct({{1 << 16, 1 << 22, 1 << 28}, {0, 1}});
+BENCHMARK(scatter_BM)->RangeMultiplier(64)->Range(1 << 16, 1 << 28);
+#endif
+
+BENCHMARK(sum_BM<int>)->Range(1 << 20, 1 << 24);
+BENCHMARK(sum_BM<float>)->Range(1 << 20, 1 << 24);
+BENCHMARK(min_BM<int>)->Range(1 << 20, 1 << 24);
+BENCHMARK(min_BM<float>)->Range(1 << 20, 1 << 24);
+BENCHMARK(count_BM<int>)->Range(1 << 20, 1 << 24);
+BENCHMARK(find_BM<int>)->Range(1 << 20, 1 << 24);
+BENCHMARK(find_BM<float>)->Range(1 << 20, 1 << 24);
+BENCHMARK(equal_BM<int>)->Range(1 << 20, 1 << 24);
+BENCHMARK(equal_BM<float>)->Range(1 << 20, 1 << 24);
+BENCHMARK(less_BM<int>)->Range(1 << 20, 1 << 24);
+
+// Sizes go well past the last level cache: 1 << 24 ints take 64 MiB.
+BENCHMARK(permuted_access_BM<int>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(permuted_access_BM<BigSizeClass<512>>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 8, 1 << 18)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(strided_access_BM<int>)
+    ->ArgsProduct({{1 << 20, 1 << 24}, {16, 1024, 2049}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(pointer_chase_BM<>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(many_vectors_access_BM<>)
+    ->RangeMultiplier(16)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+#ifdef TEST_CHUNK_VECTOR
+BENCHMARK(permuted_access_BM<int, huge_page_vector<int>>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(pointer_chase_BM<huge_page_vector<std::size_t>>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(permuted_access_BM<int, inline_table_vector<int>>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(permuted_access_BM<int, fixed_table_vector<int>>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(pointer_chase_BM<inline_table_vector<std::size_t>>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(pointer_chase_BM<fixed_table_vector<std::size_t>>)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(many_vectors_access_BM<inline_table_vector<int>>)
+    ->RangeMultiplier(16)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(partitioned_scan_BM)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK(chunk_sort_BM<int>)
+    ->RangeMultiplier(32)
+    ->Ranges({{1 << 10, 1 << 20}, {1, 1}});
+BENCHMARK(chunk_sort_BM<NonTriviallyCopyableInt>)
+    ->RangeMultiplier(32)
+    ->Ranges({{1 << 10, 1 << 20}, {1, 1}});
+BENCHMARK(chunk_sort_BM<int>)
+    ->ArgsProduct({{10'000'000}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(chunk_sort_BM<Record>)
+    ->ArgsProduct({{10'000'000}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(radix_sort_BM<int>)
+    ->RangeMultiplier(32)
+    ->Ranges({{1 << 10, 1 << 20}, {1, 1}});
+BENCHMARK(radix_sort_BM<float>)
+    ->RangeMultiplier(32)
+    ->Ranges({{1 << 10, 1 << 20}, {1, 1}});
+BENCHMARK(radix_sort_BM<int>)
+    ->ArgsProduct({{10'000'000}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(radix_sort_BM<Record>)
+    ->ArgsProduct({{10'000'000}, {1, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK(channel_messages_BM<int>)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(channel_messages_BM<Record>)
+    ->Arg(1 << 20)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Part sizes a multiple of the default int chunk size of 2048 and one past it.
+BENCHMARK(concat_append_BM<int>)->Arg(8192)->Arg(8193)->Arg(65536);
+BENCHMARK(concat_append_BM<NonTriviallyCopyableInt>)->Arg(8192)->Arg(8193);
+BENCHMARK(split_batches_BM<int>)->Arg(8192)->Arg(8193)->Arg(65536);
+
+BENCHMARK(compare_BM<int>)->Range(1 << 20, 1 << 24);
+BENCHMARK(compare_BM<float>)->Range(1 << 20, 1 << 24);
+
+#define SIMD_BENCHMARKS(name, type)                                        \
+    BENCHMARK(name<type, CustomVector::simd::level::scalar>)               \
+        ->Range(1 << 20, 1 << 24);                                         \
+    BENCHMARK(name<type, CustomVector::simd::level::sse2>)                 \
+        ->Range(1 << 20, 1 << 24);                                         \
+    BENCHMARK(name<type, CustomVector::simd::level::avx2>)                 \
+        ->Range(1 << 20, 1 << 24)
+
+SIMD_BENCHMARKS(simd_sum_BM, int);
+SIMD_BENCHMARKS(simd_sum_BM, float);
+SIMD_BENCHMARKS(simd_min_BM, int);
+SIMD_BENCHMARKS(simd_min_BM, float);
+SIMD_BENCHMARKS(simd_count_BM, int);
+SIMD_BENCHMARKS(simd_find_BM, int);
+SIMD_BENCHMARKS(simd_find_BM, float);
+SIMD_BENCHMARKS(simd_equal_BM, int);
+SIMD_BENCHMARKS(simd_equal_BM, float);
+SIMD_BENCHMARKS(simd_less_BM, int);
+#undef SIMD_BENCHMARKS
+BENCHMARK(numa_partitioned_scan_BM<CustomVector::numa_policy::first_touch>)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(numa_partitioned_scan_BM<CustomVector::numa_policy::interleave>)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(numa_partitioned_scan_BM<CustomVector::numa_policy::blocked>)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+#endif
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,772 @@
+#ifndef CHUNK_ALGORITHMS_HPP
+#define CHUNK_ALGORITHMS_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && \
+    defined(__SSE2__)
+#include <immintrin.h>
+#define CHUNK_VECTOR_X86_SIMD
+#endif
+
+namespace CustomVector {
+// Kernels over contiguous arrays, used by the container-level algorithms
+// below once per chunk. int and float get SSE2/AVX2 versions picked at run
+// time, every other type uses the scalar templates. The word kernels serve
+// the packed chunk_vector<bool>.
+namespace simd {
+enum class level { scalar, sse2, avx2 };
+
+template <typename T>
+using sum_type = std::conditional_t<
+    std::is_integral_v<T>,
+    std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>,
+    T>;
+
+inline level detected_level() noexcept {
+#ifdef CHUNK_VECTOR_X86_SIMD
+    static const level detected =
+        __builtin_cpu_supports("avx2") ? level::avx2 : level::sse2;
+    return detected;
+#else
+    return level::scalar;
+#endif
+}
+
+inline level &active_level_ref() noexcept {
+    static level active = detected_level();
+    return active;
+}
+
+inline level active_level() noexcept {
+    return active_level_ref();
+}
+
+// Restricts the kernels to `requested` or the best supported level below it.
+// Meant for tests and benchmarks; not synchronized with running algorithms.
+inline void set_level(level requested) noexcept {
+    active_level_ref() = std::min(requested, detected_level());
+}
+
+// Scalar kernels
+template <typename T>
+sum_type<T> sum(const T *data, std::size_t n, sum_type<T> init) {
+    for (std::size_t i = 0; i < n; ++i) {
+        init += data[i];
+    }
+    return init;
+}
+
+template <typename T>
+T min(const T *data, std::size_t n, T init) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (data[i] < init) {
+            init = data[i];
+        }
+    }
+    return init;
+}
+
+template <typename T>
+T max(const T *data, std::size_t n, T init) {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (init < data[i]) {
+            init = data[i];
+        }
+    }
+    return init;
+}
+
+template <typename T>
+std::size_t count(const T *data, std::size_t n, const T &value) {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        result += data[i] == value ? 1 : 0;
+    }
+    return result;
+}
+
+// Index of the first element equal to value, or n.
+template <typename T>
+std::size_t find(const T *data, std::size_t n, const T &value) {
+    return std::find(data, data + n, value) - data;
+}
+
+// Index of the first i with lhs[i] != rhs[i], or n.
+template <typename T>
+std::size_t mismatch(const T *lhs, const T *rhs, std::size_t n) {
+    return std::mismatch(lhs, lhs + n, rhs).first - lhs;
+}
+
+// dst[i] op= src[i] for words of bits.
+template <typename Word>
+void and_words(Word *dst, const Word *src, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] &= src[i];
+    }
+}
+
+template <typename Word>
+void or_words(Word *dst, const Word *src, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] |= src[i];
+    }
+}
+
+template <typename Word>
+void xor_words(Word *dst, const Word *src, std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) {
+        dst[i] ^= src[i];
+    }
+}
+
+// Number of set bits.
+template <typename Word>
+std::size_t count_bits(const Word *data, std::size_t n) {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        result += __builtin_popcountll(data[i]);
+    }
+    return result;
+}
+
+#ifdef CHUNK_VECTOR_X86_SIMD
+// SSE2 kernels (always available on x86-64)
+inline long long sum_sse2(const int *data, std::size_t n, long long init) {
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i x =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i sign = _mm_srai_epi32(x, 31);
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(x, sign));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(x, sign));
+    }
+    alignas(16) long long lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    return sum(data + i, n - i, init + lanes[0] + lanes[1]);
+}
+
+inline float sum_sse2(const float *data, std::size_t n, float init) {
+    __m128 acc = _mm_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_add_ps(acc, _mm_loadu_ps(data + i));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc);
+    return sum(
+        data + i, n - i, init + ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]))
+    );
+}
+
+inline int min_sse2(const int *data, std::size_t n, int init) {
+    __m128i acc = _mm_set1_epi32(init);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i x =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i less = _mm_cmplt_epi32(x, acc);
+        acc = _mm_or_si128(_mm_and_si128(less, x), _mm_andnot_si128(less, acc));
+    }
+    alignas(16) int lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    return min(data + i, n - i, min(lanes, 4, init));
+}
+
+inline int max_sse2(const int *data, std::size_t n, int init) {
+    __m128i acc = _mm_set1_epi32(init);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128i x =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i greater = _mm_cmpgt_epi32(x, acc);
+        acc = _mm_or_si128(
+            _mm_and_si128(greater, x), _mm_andnot_si128(greater, acc)
+        );
+    }
+    alignas(16) int lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    return max(data + i, n - i, max(lanes, 4, init));
+}
+
+inline float min_sse2(const float *data, std::size_t n, float init) {
+    __m128 acc = _mm_set1_ps(init);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_min_ps(_mm_loadu_ps(data + i), acc);
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc);
+    return min(data + i, n - i, min(lanes, 4, init));
+}
+
+inline float max_sse2(const float *data, std::size_t n, float init) {
+    __m128 acc = _mm_set1_ps(init);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_max_ps(_mm_loadu_ps(data + i), acc);
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, acc);
+    return max(data + i, n - i, max(lanes, 4, init));
+}
+
+inline int equal_mask_sse2(const int *data, __m128i value) {
+    const __m128i x =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(x, value)));
+}
+
+inline int equal_mask_sse2(const float *data, __m128 value) {
+    return _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(data), value));
+}
+
+inline int equal_mask_sse2(const int *lhs, const int *rhs) {
+    return equal_mask_sse2(
+        lhs, _mm_loadu_si128(reinterpret_cast<const __m128i *>(rhs))
+    );
+}
+
+inline int equal_mask_sse2(const float *lhs, const float *rhs) {
+    return equal_mask_sse2(lhs, _mm_loadu_ps(rhs));
+}
+
+inline __m128i broadcast_sse2(int value) {
+    return _mm_set1_epi32(value);
+}
+
+inline __m128 broadcast_sse2(float value) {
+    return _mm_set1_ps(value);
+}
+
+template <typename T>
+std::size_t count_sse2(const T *data, std::size_t n, T value) {
+    const auto wide = broadcast_sse2(value);
+    std::size_t result = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        result += __builtin_popcount(equal_mask_sse2(data + i, wide));
+    }
+    return result + count(data + i, n - i, value);
+}
+
+template <typename T>
+std::size_t find_sse2(const T *data, std::size_t n, T value) {
+    const auto wide = broadcast_sse2(value);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (const int mask = equal_mask_sse2(data + i, wide)) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + find(data + i, n - i, value);
+}
+
+template <typename T>
+std::size_t mismatch_sse2(const T *lhs, const T *rhs, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        if (const int mask = equal_mask_sse2(lhs + i, rhs + i) ^ 0xF) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + mismatch(lhs + i, rhs + i, n - i);
+}
+
+inline void
+and_words_sse2(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        auto *d = reinterpret_cast<__m128i *>(dst + i);
+        const auto *s = reinterpret_cast<const __m128i *>(src + i);
+        _mm_storeu_si128(
+            d, _mm_and_si128(_mm_loadu_si128(d), _mm_loadu_si128(s))
+        );
+    }
+    and_words(dst + i, src + i, n - i);
+}
+
+inline void
+or_words_sse2(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        auto *d = reinterpret_cast<__m128i *>(dst + i);
+        const auto *s = reinterpret_cast<const __m128i *>(src + i);
+        _mm_storeu_si128(
+            d, _mm_or_si128(_mm_loadu_si128(d), _mm_loadu_si128(s))
+        );
+    }
+    or_words(dst + i, src + i, n - i);
+}
+
+inline void
+xor_words_sse2(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        auto *d = reinterpret_cast<__m128i *>(dst + i);
+        const auto *s = reinterpret_cast<const __m128i *>(src + i);
+        _mm_storeu_si128(
+            d, _mm_xor_si128(_mm_loadu_si128(d), _mm_loadu_si128(s))
+        );
+    }
+    xor_words(dst + i, src + i, n - i);
+}
+
+// SSE2 has no population count: the bits are summed within 2-, 4- and 8-bit
+// fields, and _mm_sad_epu8 adds up the bytes of each 64-bit lane.
+inline std::size_t count_bits_sse2(const std::uint64_t *data, std::size_t n) {
+    const __m128i ones = _mm_set1_epi8(0x55);
+    const __m128i pairs = _mm_set1_epi8(0x33);
+    const __m128i nibbles = _mm_set1_epi8(0x0f);
+    __m128i acc = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i x =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi64(x, 1), ones));
+        x = _mm_add_epi8(
+            _mm_and_si128(x, pairs), _mm_and_si128(_mm_srli_epi64(x, 2), pairs)
+        );
+        x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi64(x, 4)), nibbles);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(x, _mm_setzero_si128()));
+    }
+    alignas(16) std::uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    return lanes[0] + lanes[1] + count_bits(data + i, n - i);
+}
+
+// AVX2 kernels, only called after __builtin_cpu_supports("avx2")
+#define CHUNK_VECTOR_AVX2 __attribute__((target("avx2")))
+
+CHUNK_VECTOR_AVX2 inline long long
+sum_avx2(const int *data, std::size_t n, long long init) {
+    __m256i acc_low = _mm256_setzero_si256();
+    __m256i acc_high = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i x =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        acc_low = _mm256_add_epi64(
+            acc_low, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x))
+        );
+        acc_high = _mm256_add_epi64(
+            acc_high, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1))
+        );
+    }
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(
+        reinterpret_cast<__m256i *>(lanes), _mm256_add_epi64(acc_low, acc_high)
+    );
+    return sum(
+        data + i, n - i, init + ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3]))
+    );
+}
+
+CHUNK_VECTOR_AVX2 inline float
+sum_avx2(const float *data, std::size_t n, float init) {
+    __m256 acc = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_loadu_ps(data + i));
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    float result = 0;
+    for (float lane : lanes) {
+        result += lane;
+    }
+    return sum(data + i, n - i, init + result);
+}
+
+CHUNK_VECTOR_AVX2 inline int
+min_avx2(const int *data, std::size_t n, int init) {
+    __m256i acc = _mm256_set1_epi32(init);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_min_epi32(
+            acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i))
+        );
+    }
+    alignas(32) int lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    return min(data + i, n - i, min(lanes, 8, init));
+}
+
+CHUNK_VECTOR_AVX2 inline int
+max_avx2(const int *data, std::size_t n, int init) {
+    __m256i acc = _mm256_set1_epi32(init);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_max_epi32(
+            acc, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i))
+        );
+    }
+    alignas(32) int lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), acc);
+    return max(data + i, n - i, max(lanes, 8, init));
+}
+
+CHUNK_VECTOR_AVX2 inline float
+min_avx2(const float *data, std::size_t n, float init) {
+    __m256 acc = _mm256_set1_ps(init);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_min_ps(_mm256_loadu_ps(data + i), acc);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    return min(data + i, n - i, min(lanes, 8, init));
+}
+
+CHUNK_VECTOR_AVX2 inline float
+max_avx2(const float *data, std::size_t n, float init) {
+    __m256 acc = _mm256_set1_ps(init);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_max_ps(_mm256_loadu_ps(data + i), acc);
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, acc);
+    return max(data + i, n - i, max(lanes, 8, init));
+}
+
+CHUNK_VECTOR_AVX2 inline int equal_mask_avx2(const int *data, __m256i value) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+    return _mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(x, value))
+    );
+}
+
+CHUNK_VECTOR_AVX2 inline int equal_mask_avx2(const float *data, __m256 value) {
+    return _mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(data), value, _CMP_EQ_OQ)
+    );
+}
+
+CHUNK_VECTOR_AVX2 inline int equal_mask_avx2(const int *lhs, const int *rhs) {
+    return equal_mask_avx2(
+        lhs, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rhs))
+    );
+}
+
+CHUNK_VECTOR_AVX2 inline int
+equal_mask_avx2(const float *lhs, const float *rhs) {
+    return equal_mask_avx2(lhs, _mm256_loadu_ps(rhs));
+}
+
+CHUNK_VECTOR_AVX2 inline __m256i broadcast_avx2(int value) {
+    return _mm256_set1_epi32(value);
+}
+
+CHUNK_VECTOR_AVX2 inline __m256 broadcast_avx2(float value) {
+    return _mm256_set1_ps(value);
+}
+
+template <typename T>
+CHUNK_VECTOR_AVX2 std::size_t
+count_avx2(const T *data, std::size_t n, T value) {
+    const auto wide = broadcast_avx2(value);
+    std::size_t result = 0;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        result += __builtin_popcount(equal_mask_avx2(data + i, wide));
+    }
+    return result + count(data + i, n - i, value);
+}
+
+template <typename T>
+CHUNK_VECTOR_AVX2 std::size_t find_avx2(const T *data, std::size_t n, T value) {
+    const auto wide = broadcast_avx2(value);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        if (const int mask = equal_mask_avx2(data + i, wide)) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + find(data + i, n - i, value);
+}
+
+template <typename T>
+CHUNK_VECTOR_AVX2 std::size_t
+mismatch_avx2(const T *lhs, const T *rhs, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        if (const int mask = equal_mask_avx2(lhs + i, rhs + i) ^ 0xFF) {
+            return i + __builtin_ctz(mask);
+        }
+    }
+    return i + mismatch(lhs + i, rhs + i, n - i);
+}
+
+CHUNK_VECTOR_AVX2 inline void
+and_words_avx2(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto *d = reinterpret_cast<__m256i *>(dst + i);
+        const auto *s = reinterpret_cast<const __m256i *>(src + i);
+        _mm256_storeu_si256(
+            d, _mm256_and_si256(_mm256_loadu_si256(d), _mm256_loadu_si256(s))
+        );
+    }
+    and_words(dst + i, src + i, n - i);
+}
+
+CHUNK_VECTOR_AVX2 inline void
+or_words_avx2(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto *d = reinterpret_cast<__m256i *>(dst + i);
+        const auto *s = reinterpret_cast<const __m256i *>(src + i);
+        _mm256_storeu_si256(
+            d, _mm256_or_si256(_mm256_loadu_si256(d), _mm256_loadu_si256(s))
+        );
+    }
+    or_words(dst + i, src + i, n - i);
+}
+
+CHUNK_VECTOR_AVX2 inline void
+xor_words_avx2(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto *d = reinterpret_cast<__m256i *>(dst + i);
+        const auto *s = reinterpret_cast<const __m256i *>(src + i);
+        _mm256_storeu_si256(
+            d, _mm256_xor_si256(_mm256_loadu_si256(d), _mm256_loadu_si256(s))
+        );
+    }
+    xor_words(dst + i, src + i, n - i);
+}
+
+// Every AVX2 processor has POPCNT.
+__attribute__((target("avx2,popcnt"))) inline std::size_t
+count_bits_avx2(const std::uint64_t *data, std::size_t n) {
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        result += __builtin_popcountll(data[i]);
+    }
+    return result;
+}
+
+#undef CHUNK_VECTOR_AVX2
+#endif
+
+// Dispatching overloads for int and float
+#ifdef CHUNK_VECTOR_X86_SIMD
+#define CHUNK_VECTOR_DISPATCH(name, ...)           \
+    switch (active_level()) {                      \
+        case level::avx2:                          \
+            return name##_avx2(__VA_ARGS__);       \
+        case level::sse2:                          \
+            return name##_sse2(__VA_ARGS__);       \
+        case level::scalar:                        \
+            break;                                 \
+    }
+#else
+#define CHUNK_VECTOR_DISPATCH(name, ...)
+#endif
+
+inline long long sum(const int *data, std::size_t n, long long init) {
+    CHUNK_VECTOR_DISPATCH(sum, data, n, init);
+    return sum<int>(data, n, init);
+}
+
+inline float sum(const float *data, std::size_t n, float init) {
+    CHUNK_VECTOR_DISPATCH(sum, data, n, init);
+    return sum<float>(data, n, init);
+}
+
+inline int min(const int *data, std::size_t n, int init) {
+    CHUNK_VECTOR_DISPATCH(min, data, n, init);
+    return min<int>(data, n, init);
+}
+
+inline float min(const float *data, std::size_t n, float init) {
+    CHUNK_VECTOR_DISPATCH(min, data, n, init);
+    return min<float>(data, n, init);
+}
+
+inline int max(const int *data, std::size_t n, int init) {
+    CHUNK_VECTOR_DISPATCH(max, data, n, init);
+    return max<int>(data, n, init);
+}
+
+inline float max(const float *data, std::size_t n, float init) {
+    CHUNK_VECTOR_DISPATCH(max, data, n, init);
+    return max<float>(data, n, init);
+}
+
+inline std::size_t count(const int *data, std::size_t n, const int &value) {
+    CHUNK_VECTOR_DISPATCH(count, data, n, value);
+    return count<int>(data, n, value);
+}
+
+inline std::size_t count(const float *data, std::size_t n, const float &value) {
+    CHUNK_VECTOR_DISPATCH(count, data, n, value);
+    return count<float>(data, n, value);
+}
+
+inline std::size_t find(const int *data, std::size_t n, const int &value) {
+    CHUNK_VECTOR_DISPATCH(find, data, n, value);
+    return find<int>(data, n, value);
+}
+
+inline std::size_t find(const float *data, std::size_t n, const float &value) {
+    CHUNK_VECTOR_DISPATCH(find, data, n, value);
+    return find<float>(data, n, value);
+}
+
+inline std::size_t mismatch(const int *lhs, const int *rhs, std::size_t n) {
+    CHUNK_VECTOR_DISPATCH(mismatch, lhs, rhs, n);
+    return mismatch<int>(lhs, rhs, n);
+}
+
+inline std::size_t mismatch(const float *lhs, const float *rhs, std::size_t n) {
+    CHUNK_VECTOR_DISPATCH(mismatch, lhs, rhs, n);
+    return mismatch<float>(lhs, rhs, n);
+}
+
+inline void
+and_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    CHUNK_VECTOR_DISPATCH(and_words, dst, src, n);
+    and_words<std::uint64_t>(dst, src, n);
+}
+
+inline void
+or_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    CHUNK_VECTOR_DISPATCH(or_words, dst, src, n);
+    or_words<std::uint64_t>(dst, src, n);
+}
+
+inline void
+xor_words(std::uint64_t *dst, const std::uint64_t *src, std::size_t n) {
+    CHUNK_VECTOR_DISPATCH(xor_words, dst, src, n);
+    xor_words<std::uint64_t>(dst, src, n);
+}
+
+inline std::size_t count_bits(const std::uint64_t *data, std::size_t n) {
+    CHUNK_VECTOR_DISPATCH(count_bits, data, n);
+    return count_bits<std::uint64_t>(data, n);
+}
+
+#undef CHUNK_VECTOR_DISPATCH
+}  // namespace simd
+
+// Container-level algorithms. They walk the container chunk by chunk with raw
+// pointers, so the kernels see contiguous arrays instead of indexed access.
+template <class Vector>
+simd::sum_type<typename Vector::value_type> sum(const Vector &v) {
+    using value_type = typename Vector::value_type;
+    simd::sum_type<value_type> result{};
+    v.for_each_chunk([&](const value_type *data, std::size_t n) {
+        result = simd::sum(data, n, result);
+    });
+    return result;
+}
+
+// Smallest element; v must not be empty.
+template <class Vector>
+typename Vector::value_type min_value(const Vector &v) {
+    using value_type = typename Vector::value_type;
+    value_type result = v.front();
+    v.for_each_chunk([&](const value_type *data, std::size_t n) {
+        result = simd::min(data, n, result);
+    });
+    return result;
+}
+
+// Largest element; v must not be empty.
+template <class Vector>
+typename Vector::value_type max_value(const Vector &v) {
+    using value_type = typename Vector::value_type;
+    value_type result = v.front();
+    v.for_each_chunk([&](const value_type *data, std::size_t n) {
+        result = simd::max(data, n, result);
+    });
+    return result;
+}
+
+template <class Vector>
+std::size_t count(const Vector &v, const typename Vector::value_type &value) {
+    using value_type = typename Vector::value_type;
+    std::size_t result = 0;
+    v.for_each_chunk([&](const value_type *data, std::size_t n) {
+        result += simd::count(data, n, value);
+    });
+    return result;
+}
+
+template <class Vector>
+auto find(Vector &v, const typename Vector::value_type &value) {
+    std::size_t offset = 0;
+    for (std::size_t chunk = 0; chunk < v.chunk_count(); ++chunk) {
+        const std::size_t n = v.chunk_length(chunk);
+        const typename Vector::value_type *data = v.chunk_data(chunk);
+        const std::size_t index = simd::find(data, n, value);
+        if (index != n) {
+            return v.begin() + (offset + index);
+        }
+        offset += n;
+    }
+    return v.end();
+}
+
+template <class Vector, class UnaryPredicate>
+auto find_if(Vector &v, UnaryPredicate pred) {
+    std::size_t offset = 0;
+    for (std::size_t chunk = 0; chunk < v.chunk_count(); ++chunk) {
+        const auto data = v.chunk_data(chunk);
+        const std::size_t n = v.chunk_length(chunk);
+        const auto found = std::find_if(data, data + n, pred);
+        if (found != data + n) {
+            return v.begin() + (offset + (found - data));
+        }
+        offset += n;
+    }
+    return v.end();
+}
+
+template <class Vector>
+bool equal(const Vector &lhs, const Vector &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (std::size_t chunk = 0; chunk < lhs.chunk_count(); ++chunk) {
+        const std::size_t n = lhs.chunk_length(chunk);
+        if (simd::mismatch(lhs.chunk_data(chunk), rhs.chunk_data(chunk), n) !=
+            n) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Vector>
+bool lexicographical_compare(const Vector &lhs, const Vector &rhs) {
+    const std::size_t common_chunks =
+        std::min(lhs.chunk_count(), rhs.chunk_count());
+    for (std::size_t chunk = 0; chunk < common_chunks; ++chunk) {
+        const auto *left = lhs.chunk_data(chunk);
+        const auto *right = rhs.chunk_data(chunk);
+        const std::size_t n =
+            std::min(lhs.chunk_length(chunk), rhs.chunk_length(chunk));
+        // Elements that are neither equal nor ordered (NaN) are skipped, the
+        // same way std::lexicographical_compare does.
+        for (std::size_t i = simd::mismatch(left, right, n); i < n;
+             i += 1 + simd::mismatch(left + i + 1, right + i + 1, n - i - 1)) {
+            if (left[i] < right[i]) {
+                return true;
+            }
+            if (right[i] < left[i]) {
+                return false;
+            }
+        }
+    }
+    return lhs.size() < rhs.size();
+}
+}  // namespace CustomVector
+
+#endif  // CHUNK_ALGORITHMS_HPP
@@ -0,0 +1,276 @@
+#ifndef CHUNK_CHANNEL_HPP
+#define CHUNK_CHANNEL_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+namespace detail {
+// Bounded lock-free queue for exactly one pushing and one popping thread.
+// Each side keeps a cached copy of the other side's index and only reloads
+// it when the cached value says the queue is full or empty.
+template <typename Slot>
+class spsc_ring {
+private:
+    static constexpr std::size_t cache_line = 64;
+
+    std::vector<Slot> slots;
+    std::size_t mask;
+    alignas(cache_line) std::atomic<std::size_t> head{0};
+    std::size_t cached_tail = 0;
+    alignas(cache_line) std::atomic<std::size_t> tail{0};
+    std::size_t cached_head = 0;
+
+public:
+    // The capacity is rounded up to a power of two.
+    explicit spsc_ring(std::size_t capacity) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    bool try_push(const Slot &slot) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head == slots.size()) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (t - cached_head == slots.size()) {
+                return false;
+            }
+        }
+        slots[t & mask] = slot;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(Slot &slot) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (h == cached_tail) {
+                return false;
+            }
+        }
+        slot = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+}  // namespace detail
+
+// Single-producer single-consumer channel that moves whole chunks between
+// threads. The producer constructs elements in a chunk of its own and
+// publishes the chunk with one release store when it is full or on flush();
+// the consumer takes published chunks with one acquire load, so elements
+// cost no synchronization of their own. Consumed chunks go back to the
+// producer through a second lock-free ring and are reused; at most
+// max_chunks chunks are allocated, after that the producer waits for the
+// consumer.
+//
+//     chunk_channel<record> channel;
+//     // producer thread
+//     channel.push(r); ...; channel.close();
+//     // consumer thread
+//     while (channel.consume([](record *data, std::size_t n) { ... })) {
+//     }
+template <
+    typename T,
+    std::size_t chunk_size = (sizeof(T) > 8192 ? 1 : 8192 / sizeof(T)),
+    typename Alloc = std::allocator<T>>
+class chunk_channel : private alloc_wrapper<T, Alloc, void> {
+public:
+    // Member types
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+
+private:
+    struct published_chunk {
+        pointer data = nullptr;
+        size_type count = 0;
+    };
+
+    detail::spsc_ring<published_chunk> ready;
+    detail::spsc_ring<pointer> free_chunks;
+    std::atomic<bool> closed{false};
+    size_type max_chunks;
+
+    // Producer side
+    std::vector<pointer> all_chunks;
+    pointer p_chunk = nullptr;
+    size_type p_count = 0;
+
+    // Consumer side
+    published_chunk c_chunk;
+    size_type c_pos = 0;
+
+    static void wait() {
+        std::this_thread::yield();
+    }
+
+    void acquire_chunk() {
+        while (!free_chunks.try_pop(p_chunk)) {
+            if (all_chunks.size() < max_chunks) {
+                p_chunk = this->allocate(chunk_size);
+                all_chunks.push_back(p_chunk);
+                return;
+            }
+            wait();
+        }
+    }
+
+    void publish() {
+        // There are at most max_chunks chunks, so the ring is never full.
+        ready.try_push(published_chunk{p_chunk, p_count});
+        p_chunk = nullptr;
+        p_count = 0;
+    }
+
+    void destroy_chunk(published_chunk &chunk, size_type from) noexcept {
+        for (size_type i = from; i < chunk.count; ++i) {
+            chunk.data[i].~value_type();
+        }
+    }
+
+    void release_consumed_chunk() {
+        destroy_chunk(c_chunk, c_pos);
+        free_chunks.try_push(c_chunk.data);
+        c_chunk = published_chunk();
+        c_pos = 0;
+    }
+
+    bool try_take_chunk() {
+        return ready.try_pop(c_chunk);
+    }
+
+    // Waits for a published chunk; false if the channel is closed and
+    // drained.
+    bool take_chunk() {
+        while (!try_take_chunk()) {
+            if (closed.load(std::memory_order_acquire)) {
+                // Chunks published before close() are visible now.
+                return try_take_chunk();
+            }
+            wait();
+        }
+        return true;
+    }
+
+public:
+    explicit chunk_channel(
+        size_type max_chunks = 64,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc_wrapper<T, Alloc, void>(alloc),
+          ready(std::max<size_type>(max_chunks, 1)),
+          free_chunks(std::max<size_type>(max_chunks, 1)),
+          max_chunks(std::max<size_type>(max_chunks, 1)) {
+        all_chunks.reserve(this->max_chunks);
+    }
+
+    chunk_channel(const chunk_channel &) = delete;
+
+    chunk_channel &operator=(const chunk_channel &) = delete;
+
+    // Must not run concurrently with either side.
+    ~chunk_channel() {
+        if (p_chunk != nullptr) {
+            published_chunk rest{p_chunk, p_count};
+            destroy_chunk(rest, 0);
+        }
+        if (c_chunk.data != nullptr) {
+            destroy_chunk(c_chunk, c_pos);
+        }
+        published_chunk chunk;
+        while (ready.try_pop(chunk)) {
+            destroy_chunk(chunk, 0);
+        }
+        for (pointer data : all_chunks) {
+            this->deallocate(data, chunk_size);
+        }
+    }
+
+    // Producer
+    template <class... Args>
+    void emplace(Args &&...args) {
+        if (p_chunk == nullptr) {
+            acquire_chunk();
+        }
+        this->construct(p_chunk + p_count, std::forward<Args>(args)...);
+        if (++p_count == chunk_size) {
+            publish();
+        }
+    }
+
+    void push(const T &value) {
+        emplace(value);
+    }
+
+    void push(T &&value) {
+        emplace(std::move(value));
+    }
+
+    // Publishes the partially filled chunk, if any.
+    void flush() {
+        if (p_count != 0) {
+            publish();
+        }
+    }
+
+    // Flushes and tells the consumer that nothing more will come.
+    void close() {
+        flush();
+        closed.store(true, std::memory_order_release);
+    }
+
+    // Consumer
+    // Waits for the next published chunk and calls f(data, count) on it;
+    // the elements are destroyed afterwards, so f may move them out. Returns
+    // false when the channel is closed and all chunks are consumed.
+    template <class F>
+    bool consume(F f) {
+        if (c_chunk.data == nullptr && !take_chunk()) {
+            return false;
+        }
+        f(c_chunk.data + c_pos, c_chunk.count - c_pos);
+        release_consumed_chunk();
+        return true;
+    }
+
+    // Like consume, but returns false at once if no chunk is published.
+    template <class F>
+    bool try_consume(F f) {
+        if (c_chunk.data == nullptr && !try_take_chunk()) {
+            return false;
+        }
+        f(c_chunk.data + c_pos, c_chunk.count - c_pos);
+        release_consumed_chunk();
+        return true;
+    }
+
+    // Moves the next element into value, waiting for it if needed. Returns
+    // false when the channel is closed and drained.
+    bool pop(T &value) {
+        if (c_chunk.data == nullptr && !take_chunk()) {
+            return false;
+        }
+        value = std::move(c_chunk.data[c_pos]);
+        c_chunk.data[c_pos++].~value_type();
+        if (c_pos == c_chunk.count) {
+            release_consumed_chunk();
+        }
+        return true;
+    }
+};
+}  // namespace CustomVector
+
+#endif  // CHUNK_CHANNEL_HPP
@@ -0,0 +1,362 @@
+#ifndef CHUNK_RING_HPP
+#define CHUNK_RING_HPP
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+// FIFO queue over a ring of chunks. A chunk emptied by pop_front is not
+// freed but becomes the spare chunk after the tail, so a queue whose length
+// stays below its capacity allocates nothing. An optional bound limits the
+// size for try_push_back and try_emplace_back:
+//
+//     chunk_ring<int> queue(1 << 20);
+//     if (!queue.try_push_back(x)) { /* full */ }
+template <
+    typename T,
+    std::size_t chunk_size = (sizeof(T) > 8192 ? 1 : 8192 / sizeof(T)),
+    typename Alloc = std::allocator<T>>
+class chunk_ring : private alloc_wrapper<T, Alloc, void> {
+public:
+    // Member types
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer = typename std::allocator_traits<Alloc>::const_pointer;
+
+private:
+    // The front element is at r_front in chunk r_chunks[r_first_chunk], the
+    // others follow through the next chunks, wrapping around the end of
+    // r_chunks, up to r_tail in chunk r_chunks[r_last_chunk]. Chunks after
+    // the last one and before the first one are spare.
+    std::vector<pointer> r_chunks;
+    size_type r_first_chunk;
+    size_type r_last_chunk;
+    size_type r_size;
+    size_type r_bound;
+    pointer r_front;
+    pointer r_front_end;
+    pointer r_tail;
+    pointer r_tail_end;
+
+    pointer get_ptr_by_index(size_type index) const {
+        const size_type pos = (r_front - r_chunks[r_first_chunk]) + index;
+        size_type chunk = r_first_chunk + pos / chunk_size;
+        if (chunk >= r_chunks.size()) {
+            chunk -= r_chunks.size();
+        }
+        return r_chunks[chunk] + pos % chunk_size;
+    }
+
+    // Makes the front chunk the only used one, with no elements in it.
+    void reset_to_front_chunk() noexcept {
+        r_last_chunk = r_first_chunk;
+        r_front = r_tail = r_chunks[r_first_chunk];
+        r_front_end = r_tail_end = r_front + chunk_size;
+    }
+
+    // Inserts a spare chunk right after the last used one.
+    void add_chunk() {
+        pointer new_chunk = this->allocate(chunk_size);
+        if (r_chunks.empty()) {
+            r_chunks.push_back(new_chunk);
+            reset_to_front_chunk();
+            return;
+        }
+        r_chunks.insert(r_chunks.begin() + r_last_chunk + 1, new_chunk);
+        if (r_first_chunk > r_last_chunk) {
+            ++r_first_chunk;
+        }
+    }
+
+    // Moves the tail to the next chunk, recycling a spare one if there is.
+    void advance_tail() {
+        if (r_chunks.empty()) {
+            add_chunk();
+            return;
+        }
+        size_type next =
+            r_last_chunk + 1 == r_chunks.size() ? 0 : r_last_chunk + 1;
+        if (next == r_first_chunk) {
+            add_chunk();
+            next = r_last_chunk + 1;
+        }
+        r_last_chunk = next;
+        r_tail = r_chunks[next];
+        r_tail_end = r_tail + chunk_size;
+    }
+
+    void check_out_of_bound(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range(
+                "Requested index: " + std::to_string(index) +
+                ", size: " + std::to_string(size())
+            );
+        }
+    }
+
+public:
+    // Constructors
+    chunk_ring() noexcept(noexcept(std::vector<pointer>()))
+        : r_first_chunk(0),
+          r_last_chunk(0),
+          r_size(0),
+          r_bound(std::numeric_limits<size_type>::max()),
+          r_front(nullptr),
+          r_front_end(nullptr),
+          r_tail(nullptr),
+          r_tail_end(nullptr) {
+    }
+
+    explicit chunk_ring(
+        size_type bound,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc_wrapper<T, Alloc, void>(alloc),
+          r_first_chunk(0),
+          r_last_chunk(0),
+          r_size(0),
+          r_bound(bound),
+          r_front(nullptr),
+          r_front_end(nullptr),
+          r_tail(nullptr),
+          r_tail_end(nullptr) {
+    }
+
+    chunk_ring(const chunk_ring &other)
+        : alloc_wrapper<T, Alloc, void>(
+              std::allocator_traits<allocator_type>::
+                  select_on_container_copy_construction(other.get_allocator())
+          ),
+          r_first_chunk(0),
+          r_last_chunk(0),
+          r_size(0),
+          r_bound(other.r_bound),
+          r_front(nullptr),
+          r_front_end(nullptr),
+          r_tail(nullptr),
+          r_tail_end(nullptr) {
+        reserve(other.r_size);
+        for (size_type i = 0; i < other.r_size; ++i) {
+            push_back(other[i]);
+        }
+    }
+
+    chunk_ring(chunk_ring &&other) noexcept
+        : alloc_wrapper<T, Alloc, void>(std::move(other.get_alloc_ref())),
+          r_chunks(std::move(other.r_chunks)),
+          r_first_chunk(std::exchange(other.r_first_chunk, 0)),
+          r_last_chunk(std::exchange(other.r_last_chunk, 0)),
+          r_size(std::exchange(other.r_size, 0)),
+          r_bound(other.r_bound),
+          r_front(std::exchange(other.r_front, nullptr)),
+          r_front_end(std::exchange(other.r_front_end, nullptr)),
+          r_tail(std::exchange(other.r_tail, nullptr)),
+          r_tail_end(std::exchange(other.r_tail_end, nullptr)) {
+    }
+
+    chunk_ring &operator=(const chunk_ring &other) {
+        if (this != &other) {
+            chunk_ring copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    chunk_ring &operator=(chunk_ring &&other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~chunk_ring() {
+        clear();
+        for (pointer chunk : r_chunks) {
+            this->deallocate(chunk, chunk_size);
+        }
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->get_alloc_copy();
+    }
+
+    // Element access
+    reference at(size_type pos) & {
+        check_out_of_bound(pos);
+        return *get_ptr_by_index(pos);
+    }
+
+    [[nodiscard]] const_reference at(size_type pos) const & {
+        check_out_of_bound(pos);
+        return *get_ptr_by_index(pos);
+    }
+
+    reference operator[](size_type pos) & noexcept {
+        return *get_ptr_by_index(pos);
+    }
+
+    const_reference operator[](size_type pos) const & noexcept {
+        return *get_ptr_by_index(pos);
+    }
+
+    reference front() & noexcept {
+        return *r_front;
+    }
+
+    [[nodiscard]] const_reference front() const & noexcept {
+        return *r_front;
+    }
+
+    reference back() & noexcept {
+        return *(r_tail - 1);
+    }
+
+    [[nodiscard]] const_reference back() const & noexcept {
+        return *(r_tail - 1);
+    }
+
+    // Capacity
+    [[nodiscard]] bool empty() const noexcept {
+        return r_size == 0;
+    }
+
+    [[nodiscard]] bool full() const noexcept {
+        return r_size >= r_bound;
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return r_size;
+    }
+
+    // The bound given on construction.
+    [[nodiscard]] size_type max_size() const noexcept {
+        return r_bound;
+    }
+
+    // Elements that fit without allocating; the offset of the front element
+    // in its chunk is not usable until the chunk is recycled.
+    [[nodiscard]] size_type capacity() const noexcept {
+        if (r_chunks.empty()) {
+            return 0;
+        }
+        return r_chunks.size() * chunk_size -
+               (r_front - r_chunks[r_first_chunk]);
+    }
+
+    void reserve(size_type k) & {
+        while (capacity() < k) {
+            add_chunk();
+        }
+    }
+
+    // Frees the spare chunks.
+    void shrink_to_fit() & {
+        if (r_size == 0) {
+            for (pointer chunk : r_chunks) {
+                this->deallocate(chunk, chunk_size);
+            }
+            r_chunks.clear();
+            r_first_chunk = r_last_chunk = 0;
+            r_front = r_front_end = r_tail = r_tail_end = nullptr;
+            return;
+        }
+        std::vector<pointer> chunks;
+        for (size_type i = r_first_chunk;; i = (i + 1) % r_chunks.size()) {
+            chunks.push_back(r_chunks[i]);
+            if (i == r_last_chunk) {
+                break;
+            }
+        }
+        for (size_type i = (r_last_chunk + 1) % r_chunks.size();
+             i != r_first_chunk; i = (i + 1) % r_chunks.size()) {
+            this->deallocate(r_chunks[i], chunk_size);
+        }
+        r_chunks.swap(chunks);
+        r_first_chunk = 0;
+        r_last_chunk = r_chunks.size() - 1;
+    }
+
+    // Modifiers
+    void clear() & noexcept {
+        while (!empty()) {
+            pop_front();
+        }
+    }
+
+    void push_back(const_reference value) & {
+        emplace_back(value);
+    }
+
+    void push_back(value_type &&value) & {
+        emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args) & {
+        if (r_tail == r_tail_end) {
+            advance_tail();
+        }
+        pointer pos_for_new_value = r_tail;
+        this->construct(pos_for_new_value, std::forward<Args>(args)...);
+        ++r_tail;
+        ++r_size;
+        return *pos_for_new_value;
+    }
+
+    // Like push_back and emplace_back, but return false instead of adding
+    // an element when the queue is full.
+    bool try_push_back(const_reference value) & {
+        return try_emplace_back(value);
+    }
+
+    bool try_push_back(value_type &&value) & {
+        return try_emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    bool try_emplace_back(Args &&...args) & {
+        if (full()) {
+            return false;
+        }
+        emplace_back(std::forward<Args>(args)...);
+        return true;
+    }
+
+    void pop_front() & noexcept {
+        r_front->~value_type();
+        if (--r_size == 0) {
+            // Restart at the beginning of the front chunk.
+            reset_to_front_chunk();
+        } else if (++r_front == r_front_end) {
+            if (++r_first_chunk == r_chunks.size()) {
+                r_first_chunk = 0;
+            }
+            r_front = r_chunks[r_first_chunk];
+            r_front_end = r_front + chunk_size;
+        }
+    }
+
+    void swap(chunk_ring &other) noexcept {
+        r_chunks.swap(other.r_chunks);
+        std::swap(r_first_chunk, other.r_first_chunk);
+        std::swap(r_last_chunk, other.r_last_chunk);
+        std::swap(r_size, other.r_size);
+        std::swap(r_bound, other.r_bound);
+        std::swap(r_front, other.r_front);
+        std::swap(r_front_end, other.r_front_end);
+        std::swap(r_tail, other.r_tail);
+        std::swap(r_tail_end, other.r_tail_end);
+    }
+};
+}  // namespace CustomVector
+
+#endif  // CHUNK_RING_HPP
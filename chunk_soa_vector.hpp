@@ -0,0 +1,405 @@
+#ifndef CHUNK_SOA_VECTOR_HPP
+#define CHUNK_SOA_VECTOR_HPP
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+namespace detail {
+template <typename Record>
+struct soa_chunk_size;
+
+// Elements per chunk for the chunks of the widest field to take about
+// 8 KiB. All fields use the same count, so their chunks line up.
+template <typename... Fields>
+struct soa_chunk_size<std::tuple<Fields...>> {
+    static constexpr std::size_t widest = std::max({sizeof(Fields)...});
+    static constexpr std::size_t value = widest > 8192 ? 1 : 8192 / widest;
+};
+
+// Keeps bool columns unpacked, so fields can be referenced as bool &.
+struct unpacked_bools {};
+}  // namespace detail
+
+// Structure-of-arrays counterpart of chunk_vector<std::tuple<Fields...>>:
+// each field is kept in a chunk_vector of its own, a column, and all columns
+// have the same chunk_size, so element i is in chunk i / chunk_size of every
+// column. Scanning one field reads the chunks of that field only. Whole
+// records are accessed through tuples of references to their fields.
+//
+//     chunk_soa_vector<std::tuple<int, double>> v;
+//     v.emplace_back(1, 2.5);
+//     auto [id, price] = v[0];  // int &, double &
+//     long long ids = sum(v.column<0>());
+template <
+    typename Record,
+    std::size_t chunk_size = detail::soa_chunk_size<Record>::value,
+    typename Alloc = std::allocator<char>>
+class chunk_soa_vector;
+
+template <typename... Fields, std::size_t chunk_size, typename Alloc>
+class chunk_soa_vector<std::tuple<Fields...>, chunk_size, Alloc> {
+    static_assert(sizeof...(Fields) > 0, "a record needs at least one field");
+
+public:
+    // Member types
+    using value_type = std::tuple<Fields...>;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::tuple<Fields &...>;
+    using const_reference = std::tuple<const Fields &...>;
+
+    template <std::size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+
+private:
+    template <typename Field>
+    using column_of = chunk_vector<
+        Field,
+        chunk_size,
+        typename std::allocator_traits<Alloc>::template rebind_alloc<Field>,
+        chunk_size,
+        heap_chunk_table,
+        std::conditional_t<
+            std::is_same_v<Field, bool>,
+            detail::unpacked_bools,
+            void>>;
+
+public:
+    template <std::size_t I>
+    using column_type = column_of<field_type<I>>;
+
+private:
+    template <bool is_const>
+    class record_iterator {
+    private:
+        using Owner = std::conditional_t<
+            is_const,
+            const chunk_soa_vector,
+            chunk_soa_vector>;
+        Owner *m_owner;
+        size_type m_index;
+
+    public:
+        // The records are proxies, so only input iterator requirements hold.
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename chunk_soa_vector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::conditional_t<
+            is_const,
+            typename chunk_soa_vector::const_reference,
+            typename chunk_soa_vector::reference>;
+
+        record_iterator() noexcept : m_owner(nullptr), m_index(0) {
+        }
+
+        record_iterator(Owner *owner, size_type index) noexcept
+            : m_owner(owner), m_index(index) {
+        }
+
+        operator record_iterator<true>() const noexcept {
+            return record_iterator<true>(m_owner, m_index);
+        }
+
+        reference operator*() const noexcept {
+            return (*m_owner)[m_index];
+        }
+
+        record_iterator &operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+
+        record_iterator operator++(int) noexcept {
+            record_iterator copy = *this;
+            ++m_index;
+            return copy;
+        }
+
+        difference_type operator-(const record_iterator &other
+        ) const noexcept {
+            return static_cast<difference_type>(m_index - other.m_index);
+        }
+
+        bool operator==(const record_iterator &other) const noexcept {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const record_iterator &other) const noexcept {
+            return m_index != other.m_index;
+        }
+    };
+
+    std::tuple<column_of<Fields>...> s_columns;
+
+    template <class F>
+    void for_each_column(F f) {
+        std::apply([&f](auto &...column) { (f(column), ...); }, s_columns);
+    }
+
+    template <class F>
+    void for_each_column(F f) const {
+        std::apply([&f](auto &...column) { (f(column), ...); }, s_columns);
+    }
+
+    void check_out_of_bound(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range(
+                "Requested index: " + std::to_string(index) +
+                ", size: " + std::to_string(size())
+            );
+        }
+    }
+
+    // Constructs one field in each column; if a constructor throws, the
+    // fields already constructed are removed again.
+    template <std::size_t... I, class... Args>
+    void emplace_fields(std::index_sequence<I...>, Args &&...args) {
+        reserve(size() + 1);
+        size_type done = 0;
+        try {
+            ((std::get<I>(s_columns).emplace_back(std::forward<Args>(args)),
+              ++done),
+             ...);
+        } catch (...) {
+            ((I < done ? std::get<I>(s_columns).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+public:
+    using iterator = record_iterator<false>;
+    using const_iterator = record_iterator<true>;
+
+    chunk_soa_vector() = default;
+
+    explicit chunk_soa_vector(const allocator_type &alloc)
+        : s_columns(column_of<Fields>(
+              typename column_of<Fields>::allocator_type(alloc)
+          )...) {
+    }
+
+    explicit chunk_soa_vector(
+        size_type count,
+        const allocator_type &alloc = allocator_type()
+    )
+        : chunk_soa_vector(alloc) {
+        resize(count);
+    }
+
+    chunk_soa_vector(
+        std::initializer_list<value_type> init,
+        const allocator_type &alloc = allocator_type()
+    )
+        : chunk_soa_vector(alloc) {
+        reserve(init.size());
+        for (const value_type &record : init) {
+            push_back(record);
+        }
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(std::get<0>(s_columns).get_allocator());
+    }
+
+    // Element access
+    reference operator[](size_type pos) noexcept {
+        return std::apply(
+            [pos](auto &...column) { return reference(column[pos]...); },
+            s_columns
+        );
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        return std::apply(
+            [pos](auto &...column) { return const_reference(column[pos]...); },
+            s_columns
+        );
+    }
+
+    reference at(size_type pos) {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    [[nodiscard]] const_reference at(size_type pos) const {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    reference front() noexcept {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] const_reference front() const noexcept {
+        return (*this)[0];
+    }
+
+    reference back() noexcept {
+        return (*this)[size() - 1];
+    }
+
+    [[nodiscard]] const_reference back() const noexcept {
+        return (*this)[size() - 1];
+    }
+
+    // Field I of the element at pos, without touching the other columns.
+    template <std::size_t I>
+    field_type<I> &field(size_type pos) noexcept {
+        return std::get<I>(s_columns)[pos];
+    }
+
+    template <std::size_t I>
+    [[nodiscard]] const field_type<I> &field(size_type pos) const noexcept {
+        return std::get<I>(s_columns)[pos];
+    }
+
+    // The column of field I, for scans and the algorithms of
+    // chunk_algorithms.hpp. It is read-only, so columns can not get out of
+    // step; fields are written through field() and chunk_data().
+    template <std::size_t I>
+    [[nodiscard]] const column_type<I> &column() const noexcept {
+        return std::get<I>(s_columns);
+    }
+
+    // Chunk access
+    [[nodiscard]] size_type chunk_count() const noexcept {
+        return std::get<0>(s_columns).chunk_count();
+    }
+
+    // Field I of the elements of chunk.
+    template <std::size_t I>
+    field_type<I> *chunk_data(size_type chunk) noexcept {
+        return std::get<I>(s_columns).chunk_data(chunk);
+    }
+
+    template <std::size_t I>
+    [[nodiscard]] const field_type<I> *chunk_data(size_type chunk
+    ) const noexcept {
+        return std::get<I>(s_columns).chunk_data(chunk);
+    }
+
+    [[nodiscard]] size_type chunk_length(size_type chunk) const noexcept {
+        return std::get<0>(s_columns).chunk_length(chunk);
+    }
+
+    // Iterators
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size());
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(this, size());
+    }
+
+    // Capacity
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return std::get<0>(s_columns).size();
+    }
+
+    [[nodiscard]] size_type max_size() const noexcept {
+        size_type result = std::get<0>(s_columns).max_size();
+        for_each_column([&result](const auto &column) {
+            result = std::min(result, column.max_size());
+        });
+        return result;
+    }
+
+    void reserve(size_type count) {
+        for_each_column([count](auto &column) { column.reserve(count); });
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return std::get<0>(s_columns).capacity();
+    }
+
+    void shrink_to_fit() {
+        for_each_column([](auto &column) { column.shrink_to_fit(); });
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        for_each_column([](auto &column) { column.clear(); });
+    }
+
+    // Takes one argument per field.
+    template <class... Args>
+    reference emplace_back(Args &&...args) {
+        static_assert(
+            sizeof...(Args) == sizeof...(Fields),
+            "emplace_back takes one argument per field"
+        );
+        emplace_fields(
+            std::index_sequence_for<Fields...>(), std::forward<Args>(args)...
+        );
+        return back();
+    }
+
+    void push_back(const value_type &record) {
+        std::apply(
+            [this](const Fields &...fields) { emplace_back(fields...); }, record
+        );
+    }
+
+    void push_back(value_type &&record) {
+        std::apply(
+            [this](Fields &...fields) { emplace_back(std::move(fields)...); },
+            record
+        );
+    }
+
+    void pop_back() noexcept {
+        for_each_column([](auto &column) { column.pop_back(); });
+    }
+
+    void resize(size_type count) {
+        const size_type old_size = size();
+        reserve(count);
+        try {
+            for_each_column([count](auto &column) { column.resize(count); });
+        } catch (...) {
+            for_each_column([old_size](auto &column) {
+                column.resize(std::min(old_size, column.size()));
+            });
+            throw;
+        }
+    }
+
+    void swap(chunk_soa_vector &other) noexcept {
+        s_columns.swap(other.s_columns);
+    }
+};
+
+template <typename Record, std::size_t chunk_size, typename Alloc>
+void swap(
+    chunk_soa_vector<Record, chunk_size, Alloc> &lhs,
+    chunk_soa_vector<Record, chunk_size, Alloc> &rhs
+) noexcept {
+    lhs.swap(rhs);
+}
+}  // namespace CustomVector
+
+#endif  // CHUNK_SOA_VECTOR_HPP
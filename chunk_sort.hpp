@@ -0,0 +1,413 @@
+#ifndef CHUNK_SORT_HPP
+#define CHUNK_SORT_HPP
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace CustomVector {
+namespace detail {
+// Walks the elements of the chunks [first_chunk, last_chunk) of a vector on
+// raw pointers.
+template <class Vector>
+class chunk_cursor {
+private:
+    Vector &v;
+    std::size_t chunk;
+    std::size_t last_chunk;
+    typename Vector::pointer pos = nullptr;
+    typename Vector::pointer end = nullptr;
+
+    void load() {
+        if (chunk < last_chunk) {
+            pos = v.chunk_data(chunk);
+            end = pos + v.chunk_length(chunk);
+        }
+    }
+
+public:
+    chunk_cursor(Vector &v, std::size_t first_chunk, std::size_t last_chunk)
+        : v(v), chunk(first_chunk), last_chunk(last_chunk) {
+        load();
+    }
+
+    [[nodiscard]] bool done() const noexcept {
+        return chunk >= last_chunk;
+    }
+
+    typename Vector::reference operator*() const noexcept {
+        return *pos;
+    }
+
+    typename Vector::pointer data() const noexcept {
+        return pos;
+    }
+
+    // Elements left in the current chunk.
+    [[nodiscard]] std::size_t available() const noexcept {
+        return end - pos;
+    }
+
+    void skip(std::size_t n) {
+        pos += n;
+        if (pos == end) {
+            ++chunk;
+            load();
+        }
+    }
+
+    void advance() {
+        skip(1);
+    }
+};
+
+// Runs f(first, last) on [0, count) split into up to threads parts, the
+// calling thread taking the first part. An exception thrown by f in any part
+// is rethrown once all parts have finished, the one of the lowest part first.
+template <class F>
+void parallel_for(std::size_t count, std::size_t threads, F f) {
+    threads = std::max<std::size_t>(1, std::min(threads, count));
+    std::vector<std::exception_ptr> errors(threads);
+    const auto run = [&](std::size_t t) {
+        try {
+            f(count * t / threads, count * (t + 1) / threads);
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    try {
+        for (std::size_t t = 1; t < threads; ++t) {
+            workers.emplace_back(run, t);
+        }
+    } catch (...) {
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        throw;
+    }
+    run(0);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// Merges the sorted runs of chunks [first, middle) and [middle, last) of src
+// into out(element) calls. Ties are taken from the left run, so the merge is
+// stable.
+template <class Vector, class Compare, class Output>
+void merge_runs(
+    Vector &src,
+    std::size_t first,
+    std::size_t middle,
+    std::size_t last,
+    Compare &comp,
+    Output out
+) {
+    chunk_cursor<Vector> left(src, first, middle);
+    chunk_cursor<Vector> right(src, middle, last);
+    while (!left.done() && !right.done()) {
+        if (comp(*right, *left)) {
+            out(std::move(*right));
+            right.advance();
+        } else {
+            out(std::move(*left));
+            left.advance();
+        }
+    }
+    for (; !left.done(); left.advance()) {
+        out(std::move(*left));
+    }
+    for (; !right.done(); right.advance()) {
+        out(std::move(*right));
+    }
+}
+
+// Same as merge_runs, but move-assigns into the already constructed chunks
+// of dst starting at chunk first. Works a block at a time: within a block no
+// cursor can reach the end of its chunk, so the inner loop runs on raw
+// pointers and picks the source without a branch.
+template <class Vector, class Compare>
+void merge_runs_into(
+    Vector &src,
+    std::size_t first,
+    std::size_t middle,
+    std::size_t last,
+    Vector &dst,
+    Compare &comp
+) {
+    chunk_cursor<Vector> left(src, first, middle);
+    chunk_cursor<Vector> right(src, middle, last);
+    chunk_cursor<Vector> out(dst, first, last);
+    while (!left.done() && !right.done()) {
+        const std::size_t block =
+            std::min({left.available(), right.available(), out.available()});
+        auto l = left.data();
+        auto r = right.data();
+        auto o = out.data();
+        for (std::size_t i = 0; i < block; ++i) {
+            const bool take_right = comp(*r, *l);
+            *o++ = std::move(take_right ? *r : *l);
+            r += take_right;
+            l += !take_right;
+        }
+        left.skip(l - left.data());
+        right.skip(r - right.data());
+        out.skip(block);
+    }
+    for (chunk_cursor<Vector> *rest : {&left, &right}) {
+        while (!rest->done()) {
+            const std::size_t block =
+                std::min(rest->available(), out.available());
+            std::move(rest->data(), rest->data() + block, out.data());
+            rest->skip(block);
+            out.skip(block);
+        }
+    }
+}
+
+template <class Vector, class Compare, class ChunkSort>
+void chunk_merge_sort(
+    Vector &v,
+    Compare comp,
+    std::size_t threads,
+    ChunkSort sort_chunk
+) {
+    const std::size_t chunks = v.chunk_count();
+    parallel_for(chunks, threads, [&](std::size_t first, std::size_t last) {
+        v.for_each_chunk(first, last, [&](auto data, std::size_t n) {
+            sort_chunk(data, data + n, comp);
+        });
+    });
+    if (chunks < 2) {
+        return;
+    }
+
+    // Bottom-up merge of runs of width chunks, ping-ponging between v and a
+    // scratch vector. With one thread the first pass constructs the scratch
+    // elements as it merges. Construction can not be split over threads, so
+    // otherwise the elements are first move-constructed into the scratch
+    // vector in one linear pass, and every merge pass move-assigns.
+    Vector scratch(v.get_allocator());
+    scratch.reserve(v.size());
+    std::size_t width = 1;
+    if (threads > 1) {
+        scratch.append_range(
+            std::make_move_iterator(v.begin()), std::make_move_iterator(v.end())
+        );
+    } else {
+        for (std::size_t first = 0; first < chunks; first += 2) {
+            merge_runs(
+                v, first, std::min(first + 1, chunks),
+                std::min(first + 2, chunks), comp,
+                [&](auto &&value) { scratch.push_back(std::move(value)); }
+            );
+        }
+        width = 2;
+    }
+    v.swap(scratch);
+
+    for (; width < chunks; width *= 2) {
+        const std::size_t pairs = (chunks + 2 * width - 1) / (2 * width);
+        parallel_for(pairs, threads, [&](std::size_t first, std::size_t last) {
+            for (std::size_t pair = first; pair < last; ++pair) {
+                const std::size_t begin = pair * 2 * width;
+                merge_runs_into(
+                    v, begin, std::min(begin + width, chunks),
+                    std::min(begin + 2 * width, chunks), scratch, comp
+                );
+            }
+        });
+        v.swap(scratch);
+    }
+}
+
+struct identity_key {
+    template <class T>
+    const T &operator()(const T &value) const noexcept {
+        return value;
+    }
+};
+
+// Maps a radix sort key to an unsigned integer with the same order: the sign
+// bit of signed integers is flipped, negative floats have all bits flipped
+// and non-negative ones only the sign bit.
+template <class Key>
+auto radix_bits(Key key) noexcept {
+    static_assert(
+        std::is_integral_v<Key> || std::is_floating_point_v<Key>,
+        "radix_sort keys must be integral or floating point"
+    );
+    static_assert(sizeof(Key) <= 8, "radix_sort keys are at most 64 bits");
+    if constexpr (std::is_floating_point_v<Key>) {
+        using bits_type =
+            std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t>;
+        bits_type bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        const bits_type sign = bits_type(1) << (sizeof(bits) * 8 - 1);
+        return (bits & sign) != 0 ? bits_type(~bits) : bits_type(bits | sign);
+    } else if constexpr (std::is_same_v<Key, bool>) {
+        return static_cast<std::uint8_t>(key);
+    } else {
+        using bits_type = std::make_unsigned_t<Key>;
+        auto bits = static_cast<bits_type>(key);
+        if constexpr (std::is_signed_v<Key>) {
+            bits ^= bits_type(1) << (sizeof(bits) * 8 - 1);
+        }
+        return bits;
+    }
+}
+}  // namespace detail
+
+// Sorts a chunk_vector without going through its iterators: every chunk is
+// sorted in place on raw pointers, then sorted runs of chunks are merged
+// pairwise through a scratch vector with the same allocator. Chunks and
+// independent merges are spread over threads when threads > 1. Needs move
+// construction and move assignment of the elements. If comp throws, the
+// exception propagates, from a worker thread as well once all threads have
+// finished, and v holds its elements in an unspecified state.
+template <class Vector, class Compare = std::less<>>
+void sort(Vector &v, Compare comp = Compare(), std::size_t threads = 1) {
+    detail::chunk_merge_sort(
+        v, comp, threads,
+        [](auto first, auto last, Compare &c) { std::sort(first, last, c); }
+    );
+}
+
+// Like sort, but keeps the order of equal elements.
+template <class Vector, class Compare = std::less<>>
+void stable_sort(Vector &v, Compare comp = Compare(), std::size_t threads = 1) {
+    detail::chunk_merge_sort(
+        v, comp, threads,
+        [](auto first, auto last, Compare &c) {
+            std::stable_sort(first, last, c);
+        }
+    );
+}
+
+// Stable LSD radix sort by key(element), which must return an integral or
+// floating point value; NaN keys are ordered by their bits. Each pass builds
+// per-thread histograms over ranges of chunks and scatters the elements into
+// the chunks of a scratch vector, then the two vectors swap their chunk
+// tables; passes in which all keys share the digit are skipped. Elements must
+// be default constructible (to fill the scratch vector) and move assignable.
+template <class Vector, class Key = detail::identity_key>
+void radix_sort(Vector &v, Key key = Key(), std::size_t threads = 1) {
+    using value_type = typename Vector::value_type;
+    using bits_type = decltype(detail::radix_bits(
+        key(std::declval<const value_type &>())
+    ));
+    constexpr std::size_t digit_bits = 8;
+    constexpr std::size_t buckets = std::size_t(1) << digit_bits;
+    using histogram = std::array<std::size_t, buckets>;
+
+    const std::size_t chunks = v.chunk_count();
+    const std::size_t parts =
+        std::max<std::size_t>(1, std::min(threads, chunks));
+    const auto part_begin = [&](std::size_t part) {
+        return chunks * part / parts;
+    };
+    std::vector<histogram> counts(parts);
+    Vector scratch(v.get_allocator());
+
+    for (std::size_t shift = 0; shift < sizeof(bits_type) * 8;
+         shift += digit_bits) {
+        const auto digit = [&](const auto &value) {
+            return static_cast<std::size_t>(
+                detail::radix_bits(key(value)) >> shift & (buckets - 1)
+            );
+        };
+        const auto count_digits = [&](std::size_t first, std::size_t last) {
+            for (std::size_t part = first; part < last; ++part) {
+                histogram &count = counts[part];
+                count.fill(0);
+                v.for_each_chunk(
+                    part_begin(part), part_begin(part + 1),
+                    [&](auto data, std::size_t n) {
+                        for (std::size_t i = 0; i < n; ++i) {
+                            ++count[digit(data[i])];
+                        }
+                    }
+                );
+            }
+        };
+        detail::parallel_for(parts, parts, count_digits);
+
+        // Turn the counts into the first output index of every (part,
+        // bucket) pair: buckets in order, parts in order within a bucket.
+        std::size_t offset = 0;
+        bool single_bucket = false;
+        for (std::size_t bucket = 0; bucket < buckets; ++bucket) {
+            std::size_t total = 0;
+            for (histogram &count : counts) {
+                total += count[bucket];
+            }
+            single_bucket = single_bucket || total == v.size();
+            for (histogram &count : counts) {
+                const std::size_t bucket_count = count[bucket];
+                count[bucket] = offset;
+                offset += bucket_count;
+            }
+        }
+        if (single_bucket) {
+            continue;
+        }
+        if (scratch.size() != v.size()) {
+            // Every element is assigned by the scatter below.
+            scratch.grow_by(v.size());
+        }
+
+        const auto scatter = [&](std::size_t first, std::size_t last) {
+            for (std::size_t part = first; part < last; ++part) {
+                // Write cursors of the buckets, found by walking the scratch
+                // chunks once since the offsets grow with the bucket.
+                std::vector<detail::chunk_cursor<Vector>> out;
+                out.reserve(buckets);
+                std::size_t chunk = 0;
+                std::size_t chunk_start = 0;
+                for (std::size_t bucket = 0; bucket < buckets; ++bucket) {
+                    const std::size_t position = counts[part][bucket];
+                    while (chunk < chunks &&
+                           chunk_start + scratch.chunk_length(chunk) <=
+                               position) {
+                        chunk_start += scratch.chunk_length(chunk++);
+                    }
+                    out.emplace_back(scratch, chunk, chunks);
+                    if (position != chunk_start) {
+                        out.back().skip(position - chunk_start);
+                    }
+                }
+                v.for_each_chunk(
+                    part_begin(part), part_begin(part + 1),
+                    [&](auto data, std::size_t n) {
+                        for (std::size_t i = 0; i < n; ++i) {
+                            detail::chunk_cursor<Vector> &cursor =
+                                out[digit(data[i])];
+                            *cursor = std::move(data[i]);
+                            cursor.advance();
+                        }
+                    }
+                );
+            }
+        };
+        detail::parallel_for(parts, parts, scatter);
+        v.swap(scratch);
+    }
+}
+}  // namespace CustomVector
+
+#endif  // CHUNK_SORT_HPP
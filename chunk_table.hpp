@@ -0,0 +1,286 @@
+#ifndef CHUNK_TABLE_HPP
+#define CHUNK_TABLE_HPP
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace CustomVector {
+namespace detail {
+// Storage for the chunk pointers past the inline ones.
+template <typename Pointer, bool bounded>
+class chunk_table_overflow {
+protected:
+    std::vector<Pointer> overflow;
+
+    static constexpr std::size_t max_overflow() noexcept {
+        return std::numeric_limits<std::size_t>::max();
+    }
+};
+
+// A bounded table has no storage besides the inline one.
+template <typename Pointer>
+class chunk_table_overflow<Pointer, true> {
+protected:
+    struct no_overflow {
+        [[noreturn]] static void push_back(Pointer) {
+            throw std::length_error("chunk_vector: chunk table is full");
+        }
+
+        static void pop_back() noexcept {
+        }
+
+        static void clear() noexcept {
+        }
+
+        static void reserve(std::size_t) noexcept {
+        }
+
+        static void shrink_to_fit() noexcept {
+        }
+
+        static void swap(const no_overflow &) noexcept {
+        }
+    };
+
+    static constexpr no_overflow overflow{};
+
+    static constexpr std::size_t max_overflow() noexcept {
+        return 0;
+    }
+};
+
+// Table of chunk pointers that keeps the first inline_chunks of them in the
+// object itself, so reaching one of those chunks takes one load less than
+// through a std::vector. The others go to a std::vector, unless the table is
+// bounded. Provides the part of the std::vector interface chunk_vector uses;
+// iterators are indices, as the pointers are not contiguous.
+template <typename Pointer, std::size_t inline_chunks, bool bounded>
+class chunk_pointer_table : private chunk_table_overflow<Pointer, bounded> {
+    static_assert(inline_chunks > 0, "inline_chunks must be positive");
+
+private:
+    Pointer t_inline[inline_chunks] = {};
+    std::size_t t_size = 0;
+
+    template <bool is_const>
+    class index_iterator {
+    private:
+        using Owner = std::conditional_t<
+            is_const,
+            const chunk_pointer_table,
+            chunk_pointer_table>;
+        Owner *t_table;
+        std::size_t t_index;
+
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = Pointer;
+        using pointer =
+            std::conditional_t<is_const, const Pointer *, Pointer *>;
+        using reference =
+            std::conditional_t<is_const, const Pointer &, Pointer &>;
+        using iterator_category = std::forward_iterator_tag;
+
+        index_iterator(Owner *table = nullptr, std::size_t index = 0)
+            : t_table(table), t_index(index) {
+        }
+
+        reference operator*() const noexcept {
+            return (*t_table)[t_index];
+        }
+
+        index_iterator &operator++() noexcept {
+            ++t_index;
+            return *this;
+        }
+
+        index_iterator operator+(std::ptrdiff_t n) const noexcept {
+            return index_iterator(t_table, t_index + n);
+        }
+
+        std::ptrdiff_t operator-(const index_iterator &other) const noexcept {
+            return t_index - other.t_index;
+        }
+
+        bool operator==(const index_iterator &other) const noexcept {
+            return t_index == other.t_index;
+        }
+
+        bool operator!=(const index_iterator &other) const noexcept {
+            return t_index != other.t_index;
+        }
+
+        [[nodiscard]] std::size_t index() const noexcept {
+            return t_index;
+        }
+    };
+
+public:
+    using value_type = Pointer;
+    using size_type = std::size_t;
+    using iterator = index_iterator<false>;
+    using const_iterator = index_iterator<true>;
+
+    chunk_pointer_table() noexcept = default;
+
+    chunk_pointer_table(const chunk_pointer_table &) = delete;
+
+    chunk_pointer_table &operator=(const chunk_pointer_table &) = delete;
+
+    chunk_pointer_table(chunk_pointer_table &&other) noexcept {
+        swap(other);
+    }
+
+    ~chunk_pointer_table() = default;
+
+    [[nodiscard]] static constexpr size_type max_size() noexcept {
+        return std::min(
+            std::numeric_limits<size_type>::max() - inline_chunks,
+            chunk_pointer_table::max_overflow()
+        ) + inline_chunks;
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return t_size;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return t_size == 0;
+    }
+
+    Pointer &operator[](size_type i) noexcept {
+        if constexpr (bounded) {
+            return t_inline[i];
+        } else {
+            return i < inline_chunks ? t_inline[i]
+                                     : this->overflow[i - inline_chunks];
+        }
+    }
+
+    const Pointer &operator[](size_type i) const noexcept {
+        if constexpr (bounded) {
+            return t_inline[i];
+        } else {
+            return i < inline_chunks ? t_inline[i]
+                                     : this->overflow[i - inline_chunks];
+        }
+    }
+
+    Pointer &back() noexcept {
+        return (*this)[t_size - 1];
+    }
+
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept {
+        return iterator(this, t_size);
+    }
+
+    void push_back(Pointer p) {
+        if (t_size < inline_chunks) {
+            t_inline[t_size] = p;
+        } else {
+            this->overflow.push_back(p);
+        }
+        ++t_size;
+    }
+
+    void pop_back() noexcept {
+        if (t_size > inline_chunks) {
+            this->overflow.pop_back();
+        }
+        --t_size;
+    }
+
+    void clear() noexcept {
+        this->overflow.clear();
+        t_size = 0;
+    }
+
+    void shrink_to_fit() {
+        this->overflow.shrink_to_fit();
+    }
+
+    // Inserts the pointers of [first, last), which must not come from this
+    // table, before pos. Leaves the table unchanged if it throws.
+    template <class ForwardIt>
+    void insert(iterator pos, ForwardIt first, ForwardIt last) {
+        const size_type index = pos.index();
+        const size_type old_size = t_size;
+        const size_type count = std::distance(first, last);
+        if (count > max_size() - old_size) {
+            throw std::length_error("chunk_vector: chunk table is full");
+        }
+        if (old_size + count > inline_chunks) {
+            this->overflow.reserve(old_size + count - inline_chunks);
+        }
+        for (size_type i = 0; i < count; ++i) {
+            push_back(Pointer());
+        }
+        for (size_type i = old_size; i > index; --i) {
+            (*this)[i - 1 + count] = (*this)[i - 1];
+        }
+        for (size_type i = index; first != last; ++first, ++i) {
+            (*this)[i] = *first;
+        }
+    }
+
+    void erase(iterator first, iterator last) noexcept {
+        const size_type count = last - first;
+        for (size_type i = last.index(); i < t_size; ++i) {
+            (*this)[i - count] = (*this)[i];
+        }
+        for (size_type i = 0; i < count; ++i) {
+            pop_back();
+        }
+    }
+
+    template <class InputIt>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    void swap(chunk_pointer_table &other) noexcept {
+        std::swap(t_inline, other.t_inline);
+        std::swap(t_size, other.t_size);
+        this->overflow.swap(other.overflow);
+    }
+};
+}  // namespace detail
+
+// Layouts of the chunk pointer table for the ChunkTable parameter of
+// chunk_vector.
+
+// All chunk pointers in a std::vector.
+struct heap_chunk_table {
+    template <typename Pointer>
+    using table = std::vector<Pointer>;
+};
+
+// The first inline_chunks chunk pointers in the chunk_vector object, the
+// others in a std::vector.
+template <std::size_t inline_chunks>
+struct inline_chunk_table {
+    template <typename Pointer>
+    using table = detail::chunk_pointer_table<Pointer, inline_chunks, false>;
+};
+
+// At most max_chunks chunks, all chunk pointers in the chunk_vector object;
+// growing past max_chunks * chunk_size elements throws std::length_error.
+template <std::size_t max_chunks>
+struct fixed_chunk_table {
+    template <typename Pointer>
+    using table = detail::chunk_pointer_table<Pointer, max_chunks, true>;
+};
+}  // namespace CustomVector
+
+#endif  // CHUNK_TABLE_HPP
@@ -1,11 +1,74 @@
 #ifndef CHUNK_VECTOR_HPP
 #define CHUNK_VECTOR_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "chunk_table.hpp"
+
 namespace CustomVector {
+// Types that chunk_vector may move with memmove; specialize for own types.
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T, typename U>
+struct is_trivially_relocatable<std::unique_ptr<T, std::default_delete<U>>>
+    : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable<std::vector<T>> : std::true_type {};
+
+template <typename T, typename U>
+struct is_trivially_relocatable<std::pair<T, U>>
+    : std::bool_constant<
+          is_trivially_relocatable<T>::value &&
+          is_trivially_relocatable<U>::value> {};
+
+// Short libstdc++ strings point into themselves.
+#ifdef _LIBCPP_VERSION
+template <typename CharT, typename Traits>
+struct is_trivially_relocatable<std::basic_string<CharT, Traits>>
+    : std::true_type {};
+#endif
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
+// Tag for gather and scatter with indices in non-decreasing order.
+struct sorted_indices_t {
+    explicit sorted_indices_t() = default;
+};
+
+inline constexpr sorted_indices_t sorted_indices{};
+
+namespace detail {
+// Prefetches the cache line of address, if the compiler supports it.
+template <bool for_write>
+inline void prefetch(const void *address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, for_write ? 1 : 0);
+#else
+    static_cast<void>(address);
+#endif
+}
+}  // namespace detail
+
 template <typename T, typename Alloc, typename>
 struct alloc_wrapper {
 private:
@@ -85,19 +148,57 @@ struct alloc_wrapper<
     }
 };
 
+// Capacity of a first chunk that grows from first_chunk_size to chunk_size.
+template <std::size_t first_chunk_size, std::size_t chunk_size>
+class first_chunk_state {
+private:
+    std::size_t capacity = chunk_size;
+
+public:
+    std::size_t first_chunk_capacity() const noexcept {
+        return capacity;
+    }
+
+    void set_first_chunk_capacity(std::size_t new_capacity) noexcept {
+        capacity = new_capacity;
+    }
+};
+
+template <std::size_t chunk_size>
+class first_chunk_state<chunk_size, chunk_size> {
+public:
+    static constexpr std::size_t first_chunk_capacity() noexcept {
+        return chunk_size;
+    }
+
+    static void set_first_chunk_capacity(std::size_t) noexcept {
+    }
+};
+
+// With first_chunk_size < chunk_size the first chunk doubles up to chunk_size.
+// ChunkTable picks where the chunk pointers live (see chunk_table.hpp).
+// The last parameter selects the packed chunk_vector<bool>; any type other
+// than void keeps one bool per byte.
 template <
     typename T,
     std::size_t chunk_size = (sizeof(T) > 8192 ? 1 : 8192 / sizeof(T)),
-    typename Alloc = std::allocator<T>>
-class chunk_vector : private alloc_wrapper<T, Alloc, void> {
+    typename Alloc = std::allocator<T>,
+    std::size_t first_chunk_size = chunk_size,
+    typename ChunkTable = heap_chunk_table,
+    typename = void>
+class chunk_vector : private alloc_wrapper<T, Alloc, void>,
+                     private first_chunk_state<first_chunk_size, chunk_size> {
+    static_assert(
+        first_chunk_size > 0 && first_chunk_size <= chunk_size,
+        "first_chunk_size must be in [1, chunk_size]"
+    );
+
 private:
     template <bool is_const>
     class chunk_iterator {
     private:
-        using Owner = std::conditional_t<
-            is_const,
-            const chunk_vector<T, chunk_size, Alloc>,
-            chunk_vector<T, chunk_size, Alloc>>;
+        using Owner =
+            std::conditional_t<is_const, const chunk_vector, chunk_vector>;
         using Value = std::conditional_t<is_const, const T, T>;
         Owner *m_chunk_vector_ptr;
         std::size_t m_index;
@@ -226,9 +327,92 @@ public:
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+    // Consecutive elements within one chunk.
+    struct span {
+        pointer data;
+        size_type size;
+
+        [[nodiscard]] pointer begin() const noexcept {
+            return data;
+        }
+
+        [[nodiscard]] pointer end() const noexcept {
+            return data + size;
+        }
+    };
+
+    // The elements [first, last) of a vector as one span per chunk.
+    class span_range {
+    private:
+        chunk_vector *r_vector;
+        size_type r_first;
+        size_type r_last;
+
+    public:
+        class span_iterator {
+        private:
+            chunk_vector *i_vector;
+            size_type i_index;
+            size_type i_last;
+
+            size_type run() const noexcept {
+                return std::min(
+                    i_last - i_index, chunk_size - i_index % chunk_size
+                );
+            }
+
+        public:
+            using difference_type = std::ptrdiff_t;
+            using value_type = span;
+            using pointer = void;
+            using reference = span;
+            using iterator_category = std::input_iterator_tag;
+
+            span_iterator(chunk_vector *v, size_type index, size_type last)
+                : i_vector(v), i_index(index), i_last(last) {
+            }
+
+            span operator*() const noexcept {
+                return span{i_vector->get_ptr_by_index(i_index), run()};
+            }
+
+            span_iterator &operator++() noexcept {
+                i_index += run();
+                return *this;
+            }
+
+            bool operator==(const span_iterator &other) const noexcept {
+                return i_index == other.i_index;
+            }
+
+            bool operator!=(const span_iterator &other) const noexcept {
+                return i_index != other.i_index;
+            }
+        };
+
+        span_range(chunk_vector *v, size_type first, size_type last)
+            : r_vector(v), r_first(first), r_last(last) {
+        }
+
+        [[nodiscard]] span_iterator begin() const noexcept {
+            return span_iterator(r_vector, r_first, r_last);
+        }
+
+        [[nodiscard]] span_iterator end() const noexcept {
+            return span_iterator(r_vector, r_last, r_last);
+        }
+
+        // Number of elements.
+        [[nodiscard]] size_type size() const noexcept {
+            return r_last - r_first;
+        }
+    };
+
 private:
+    using chunk_table = typename ChunkTable::template table<pointer>;
+
     size_type v_size;
-    std::vector<pointer> v_chunks;
+    chunk_table v_chunks;
 
     pointer get_ptr_by_index(size_type index) {
         return v_chunks[index / chunk_size] + index % chunk_size;
@@ -247,8 +431,115 @@ private:
         }
     }
 
+    static constexpr bool relocatable = is_trivially_relocatable_v<T>;
+
+    // Calls f with the address of the element at each index of [first, last).
+    template <bool for_write, class Self, class IndexIt, class F>
+    static void visit_indices(Self &self, IndexIt first, IndexIt last, F f) {
+        if constexpr (is_random_access_iterator_v<IndexIt>) {
+            const size_type n = std::distance(first, last);
+            size_type k = 0;
+            if (self.v_size * sizeof(T) >= prefetch_min_bytes) {
+                for (; k + 2 * prefetch_distance < n; ++k) {
+                    const size_type ahead = first[k + 2 * prefetch_distance];
+                    detail::prefetch<false>(&self.v_chunks[ahead / chunk_size]);
+                    detail::prefetch<for_write>(
+                        self.get_ptr_by_index(first[k + prefetch_distance])
+                    );
+                    f(self.get_ptr_by_index(first[k]));
+                }
+            }
+            for (; k < n; ++k) {
+                f(self.get_ptr_by_index(first[k]));
+            }
+        } else {
+            for (; first != last; ++first) {
+                f(self.get_ptr_by_index(*first));
+            }
+        }
+    }
+
+    // visit_indices for sorted indices, reading the chunk table once per run.
+    template <class Self, class IndexIt, class F>
+    static void
+    visit_sorted_indices(Self &self, IndexIt first, IndexIt last, F f) {
+        while (first != last) {
+            const size_type chunk = static_cast<size_type>(*first) / chunk_size;
+            const auto data = self.v_chunks[chunk];
+            const size_type run_start = chunk * chunk_size;
+            for (; first != last; ++first) {
+                const size_type i = static_cast<size_type>(*first);
+                if (i >= run_start + chunk_size) {
+                    break;
+                }
+                f(data + (i - run_start));
+            }
+        }
+    }
+
+    // Only random-access ranges are counted before they are read.
+    template <class It>
+    static constexpr bool is_random_access_iterator_v = std::is_base_of_v<
+        std::random_access_iterator_tag,
+        typename std::iterator_traits<It>::iterator_category>;
+
+    // Copies the bytes of source[from, from + count) to [to, to + count).
+    void relocate_elements(
+        const chunk_vector &source,
+        size_type from,
+        size_type to,
+        size_type count
+    ) noexcept {
+        while (count > 0) {
+            const size_type n = std::min(
+                {count, chunk_size - from % chunk_size,
+                 chunk_size - to % chunk_size}
+            );
+            std::memmove(
+                static_cast<void *>(get_ptr_by_index(to)),
+                static_cast<const void *>(source.get_ptr_by_index(from)),
+                n * sizeof(T)
+            );
+            from += n;
+            to += n;
+            count -= n;
+        }
+    }
+
+    // Same for overlapping ranges of this vector with to > from.
+    void relocate_elements_backward(
+        size_type from,
+        size_type to,
+        size_type count
+    ) noexcept {
+        while (count > 0) {
+            const size_type n = std::min(
+                {count, (from + count - 1) % chunk_size + 1,
+                 (to + count - 1) % chunk_size + 1}
+            );
+            count -= n;
+            std::memmove(
+                static_cast<void *>(get_ptr_by_index(to + count)),
+                static_cast<const void *>(get_ptr_by_index(from + count)),
+                n * sizeof(T)
+            );
+        }
+    }
+
+    // Moves the elements [start_pos, size()) by shift, keeping the size.
     void elements_shift(size_type start_pos, difference_type shift) {
-        if (shift > 0) {
+        if constexpr (relocatable) {
+            if (shift > 0) {
+                reserve(v_size + shift);
+                relocate_elements_backward(
+                    start_pos, start_pos + shift, v_size - start_pos
+                );
+            } else if (shift < 0) {
+                relocate_elements(
+                    *this, start_pos, start_pos + shift, v_size - start_pos
+                );
+            }
+        } else if (shift > 0) {
             reserve(v_size + shift);
             if (v_size == 0) {
                 return;
@@ -281,9 +572,178 @@ private:
         }
     }
 
+    // Fills the gap left by elements_shift, closing it again on exceptions.
+    template <class F>
+    void construct_in_gap(size_type index, size_type count, F construct) {
+        size_type constructed = 0;
+        try {
+            for (; constructed < count; ++constructed) {
+                construct(get_ptr_by_index(index + constructed));
+            }
+        } catch (...) {
+            for (size_type i = 0; i < constructed; ++i) {
+                std::destroy_at(get_ptr_by_index(index + i));
+            }
+            relocate_elements(*this, index + count, index, v_size - index);
+            throw;
+        }
+        v_size += count;
+    }
+
+    static constexpr bool adaptive_first_chunk = first_chunk_size < chunk_size;
+
+    // Capacity of chunk v_chunks[chunk].
+    size_type chunk_capacity(size_type chunk) const noexcept {
+        return chunk == 0 ? this->first_chunk_capacity() : chunk_size;
+    }
+
+    // Smallest first chunk capacity that holds k elements.
+    static size_type first_chunk_step(size_type k) noexcept {
+        size_type step = first_chunk_size;
+        while (step < k && step < chunk_size) {
+            step *= 2;
+        }
+        return std::min(step, chunk_size);
+    }
+
+    // Moves the only chunk to new_capacity, constructing the back first.
+    template <class F = std::nullptr_t>
+    void reallocate_first_chunk(
+        size_type new_capacity,
+        F construct_back = nullptr
+    ) {
+        constexpr bool constructs_back = !std::is_null_pointer_v<F>;
+        pointer new_chunk = this->allocate(new_capacity);
+        if (!v_chunks.empty()) {
+            pointer old_chunk = v_chunks[0];
+            if constexpr (constructs_back) {
+                try {
+                    construct_back(new_chunk + v_size);
+                } catch (...) {
+                    this->deallocate(new_chunk, new_capacity);
+                    throw;
+                }
+            }
+            if constexpr (relocatable) {
+                std::memcpy(
+                    static_cast<void *>(new_chunk),
+                    static_cast<const void *>(old_chunk), v_size * sizeof(T)
+                );
+            } else {
+                try {
+                    std::uninitialized_move(
+                        old_chunk, old_chunk + v_size, new_chunk
+                    );
+                } catch (...) {
+                    if constexpr (constructs_back) {
+                        std::destroy_at(new_chunk + v_size);
+                    }
+                    this->deallocate(new_chunk, new_capacity);
+                    throw;
+                }
+                std::destroy(old_chunk, old_chunk + v_size);
+            }
+            this->deallocate(old_chunk, this->first_chunk_capacity());
+            v_chunks[0] = new_chunk;
+        } else {
+            v_chunks.push_back(new_chunk);
+        }
+        this->set_first_chunk_capacity(new_capacity);
+    }
+
+    // Whether all chunks have chunk_size elements.
+    bool has_full_chunks() const noexcept {
+        return this->first_chunk_capacity() == chunk_size;
+    }
+
+    // Capacity the first chunk grows to for reserve(k).
+    size_type first_chunk_growth(size_type k) const noexcept {
+        return first_chunk_step(
+            std::max(k, std::min(2 * capacity(), chunk_size))
+        );
+    }
+
+    // Whether reserve(k) moves the elements to a larger first chunk.
+    bool reserve_moves_elements(size_type k) const noexcept {
+        if constexpr (adaptive_first_chunk) {
+            return v_size > 0 && !has_full_chunks() && capacity() < k;
+        } else {
+            return false;
+        }
+    }
+
+    // Appends construct(p) to the full first chunk, growing it.
+    template <class F>
+    void append_growing_first_chunk(F construct) {
+        reallocate_first_chunk(first_chunk_growth(v_size + 1), construct);
+        ++v_size;
+    }
+
+    bool shares_chunks_with(const chunk_vector &other) const {
+        if constexpr (std::allocator_traits<Alloc>::is_always_equal::value) {
+            return true;
+        } else {
+            return get_allocator() == other.get_allocator();
+        }
+    }
+
+    // Moves source[first, source.size()) to the end.
+    void move_append(chunk_vector &source, size_type first) {
+        reserve(v_size + (source.v_size - first));
+        if constexpr (relocatable) {
+            relocate_elements(source, first, v_size, source.v_size - first);
+            v_size += source.v_size - first;
+            source.v_size = first;
+            return;
+        }
+        for (size_type i = first; i < source.v_size; ++i) {
+            new (get_ptr_by_index(v_size)) value_type(std::move(source[i]));
+            ++v_size;
+        }
+        while (source.v_size > first) {
+            source[--source.v_size].~value_type();
+        }
+    }
+
+    // Types whose chunks can be compared with memcmp.
+    static constexpr bool bitwise_comparable = std::is_integral_v<T> ||
+                                               std::is_enum_v<T> ||
+                                               std::is_pointer_v<T>;
+
+    static bool
+    equal_chunks(const_pointer lhs, const_pointer rhs, size_type n) {
+        if constexpr (bitwise_comparable) {
+            return std::memcmp(lhs, rhs, n * sizeof(T)) == 0;
+        } else {
+            return std::equal(lhs, lhs + n, rhs);
+        }
+    }
+
+    // Three-way comparison of n elements using only operator<.
+    static int
+    compare_chunks(const_pointer lhs, const_pointer rhs, size_type n) {
+        if constexpr (bitwise_comparable) {
+            if (std::memcmp(lhs, rhs, n * sizeof(T)) == 0) {
+                return 0;
+            }
+            const size_type i = std::mismatch(lhs, lhs + n, rhs).first - lhs;
+            return lhs[i] < rhs[i] ? -1 : 1;
+        } else {
+            for (size_type i = 0; i < n; ++i) {
+                if (lhs[i] < rhs[i]) {
+                    return -1;
+                }
+                if (rhs[i] < lhs[i]) {
+                    return 1;
+                }
+            }
+            return 0;
+        }
+    }
+
 public:
     // Constructors
-    chunk_vector() noexcept(noexcept(std::vector<pointer>())) : v_size(0) {
+    chunk_vector() noexcept(noexcept(chunk_table())) : v_size(0) {
     }
 
     explicit chunk_vector(const allocator_type &alloc) noexcept
@@ -338,13 +798,21 @@ public:
 
     chunk_vector(chunk_vector &&other) noexcept
         : alloc_wrapper<T, Alloc, void>(std::move(other.get_alloc_ref())),
+          first_chunk_state<first_chunk_size, chunk_size>(other),
           v_size(std::exchange(other.v_size, 0)),
           v_chunks(std::move(other.v_chunks)) {
+        other.v_chunks.clear();
+        other.set_first_chunk_capacity(chunk_size);
     }
 
     chunk_vector(chunk_vector &&other, const allocator_type &alloc)
         : alloc_wrapper<T, Alloc, void>(alloc), v_size(0) {
         reserve(other.v_size);
+        if constexpr (relocatable) {
+            relocate_elements(other, 0, 0, other.v_size);
+            v_size = std::exchange(other.v_size, 0);
+            return;
+        }
         for (; v_size < other.v_size; ++v_size) {
             new (get_ptr_by_index(v_size)) value_type(std::move(other[v_size]));
         }
@@ -369,8 +837,7 @@ public:
         if (this == &other) {
             return *this;
         }
-        std::swap(v_size, other.v_size);
-        v_chunks.swap(other.v_chunks);
+        swap(other);
         return *this;
     }
 
@@ -383,8 +850,8 @@ public:
         for (size_type i = 0; i < v_size; ++i) {
             this->operator[](i).~value_type();
         }
-        for (pointer chunk : v_chunks) {
-            this->deallocate(chunk, chunk_size);
+        for (size_type i = 0; i < v_chunks.size(); ++i) {
+            this->deallocate(v_chunks[i], chunk_capacity(i));
         }
     }
 
@@ -404,6 +871,18 @@ public:
                 typename std::iterator_traits<InputIt>::iterator_category>,
             bool> = true>
     void assign(InputIt first, InputIt last) {
+        if constexpr (!is_random_access_iterator_v<InputIt>) {
+            // One pass: the range may be single-pass or slow to count.
+            size_type i = 0;
+            for (; i < v_size && first != last; ++i, ++first) {
+                operator[](i) = *first;
+            }
+            while (v_size > i) {
+                pop_back();
+            }
+            append_range(first, last);
+            return;
+        }
         size_type count = std::distance(first, last);
 
         if (count <= v_size) {
@@ -418,10 +897,7 @@ public:
             for (size_type i = 0; i < v_size; ++i) {
                 operator[](i) = *(first++);
             }
-            for (size_type i = v_size; i < count; ++i) {
-                new (get_ptr_by_index(i)) value_type(*(first++));
-                ++v_size;
-            }
+            append_range(first, last);
         }
     }
 
@@ -542,6 +1018,102 @@ public:
         return const_reverse_iterator(cbegin());
     }
 
+    // Chunk access
+    [[nodiscard]] size_type chunk_count() const noexcept {
+        return (v_size + chunk_size - 1) / chunk_size;
+    }
+
+    pointer chunk_data(size_type chunk) noexcept {
+        return v_chunks[chunk];
+    }
+
+    [[nodiscard]] const_pointer chunk_data(size_type chunk) const noexcept {
+        return v_chunks[chunk];
+    }
+
+    [[nodiscard]] size_type chunk_length(size_type chunk) const noexcept {
+        return std::min(chunk_size, v_size - chunk * chunk_size);
+    }
+
+    // Calls f(chunk_data(i), chunk_length(i)) for [first_chunk, last_chunk).
+    template <class F>
+    void for_each_chunk(size_type first_chunk, size_type last_chunk, F f) {
+        for (size_type i = first_chunk; i < last_chunk; ++i) {
+            f(chunk_data(i), chunk_length(i));
+        }
+    }
+
+    template <class F>
+    void
+    for_each_chunk(size_type first_chunk, size_type last_chunk, F f) const {
+        for (size_type i = first_chunk; i < last_chunk; ++i) {
+            f(chunk_data(i), chunk_length(i));
+        }
+    }
+
+    template <class F>
+    void for_each_chunk(F f) {
+        for_each_chunk(0, chunk_count(), f);
+    }
+
+    template <class F>
+    void for_each_chunk(F f) const {
+        for_each_chunk(0, chunk_count(), f);
+    }
+
+    // Batched access
+    static constexpr size_type prefetch_distance = 8;
+    // Smaller vectors are likely cached and are not prefetched.
+    static constexpr size_type prefetch_min_bytes = size_type(4) << 20;
+
+    // Writes the elements at the indices of [first, last) to out.
+    template <class IndexIt, class OutputIt>
+    OutputIt gather(IndexIt first, IndexIt last, OutputIt out) const {
+        visit_indices<false>(*this, first, last, [&out](const_pointer p) {
+            *out = *p;
+            ++out;
+        });
+        return out;
+    }
+
+    // gather for indices in non-decreasing order.
+    template <class IndexIt, class OutputIt>
+    OutputIt
+    gather(sorted_indices_t, IndexIt first, IndexIt last, OutputIt out) const {
+        visit_sorted_indices(
+            *this, first, last,
+            [&out](const_pointer p) {
+                *out = *p;
+                ++out;
+            }
+        );
+        return out;
+    }
+
+    // Assigns values to the elements at the indices of [first, last) in order.
+    template <class IndexIt, class InputIt>
+    InputIt scatter(IndexIt first, IndexIt last, InputIt values) & {
+        visit_indices<true>(*this, first, last, [&values](pointer p) {
+            *p = *values;
+            ++values;
+        });
+        return values;
+    }
+
+    // scatter for indices in non-decreasing order.
+    template <class IndexIt, class InputIt>
+    InputIt
+    scatter(sorted_indices_t, IndexIt first, IndexIt last, InputIt values) & {
+        visit_sorted_indices(
+            *this, first, last,
+            [&values](pointer p) {
+                *p = *values;
+                ++values;
+            }
+        );
+        return values;
+    }
+
     // Capacity
     [[nodiscard]] bool empty() const noexcept {
         return v_size == 0;
@@ -552,10 +1124,31 @@ public:
     }
 
     [[nodiscard]] size_type max_size() const noexcept {
-        return std::numeric_limits<size_type>::max();
+        if constexpr (std::is_same_v<chunk_table, std::vector<pointer>>) {
+            return std::numeric_limits<size_type>::max();
+        } else {
+            return std::min(
+                chunk_table::max_size(),
+                std::numeric_limits<size_type>::max() / chunk_size
+            ) * chunk_size;
+        }
     }
 
     void reserve(size_type k) & {
+        if (k > max_size()) {
+            throw std::length_error(
+                "Requested capacity: " + std::to_string(k) +
+                ", max_size: " + std::to_string(max_size())
+            );
+        }
+        if constexpr (adaptive_first_chunk) {
+            if (capacity() >= k) {
+                return;
+            }
+            if (v_chunks.empty() || !has_full_chunks()) {
+                reallocate_first_chunk(first_chunk_growth(k));
+            }
+        }
         while (capacity() < k) {
             pointer new_chunk = this->allocate(chunk_size);
             v_chunks.push_back(new_chunk);
@@ -563,14 +1156,27 @@ public:
     }
 
     [[nodiscard]] size_type capacity() const noexcept {
-        return v_chunks.size() * chunk_size;
+        // Only the first chunk can be smaller.
+        return v_chunks.size() * chunk_size -
+               (chunk_size - this->first_chunk_capacity());
     }
 
     void shrink_to_fit() & {
-        while (capacity() - v_size >= chunk_size) {
-            this->deallocate(v_chunks.back(), chunk_size);
+        while (!v_chunks.empty() &&
+               capacity() - v_size >= chunk_capacity(v_chunks.size() - 1)) {
+            this->deallocate(
+                v_chunks.back(), chunk_capacity(v_chunks.size() - 1)
+            );
             v_chunks.pop_back();
         }
+        if constexpr (adaptive_first_chunk) {
+            if (v_chunks.empty()) {
+                this->set_first_chunk_capacity(chunk_size);
+            } else if (v_chunks.size() == 1 &&
+                       first_chunk_step(v_size) < capacity()) {
+                reallocate_first_chunk(first_chunk_step(v_size));
+            }
+        }
         v_chunks.shrink_to_fit();
     }
 
@@ -582,10 +1188,19 @@ public:
         v_size = 0;
     }
 
+    // The inserts copy an argument that growing the first chunk would free.
     iterator insert(const_iterator pos, const_reference value) & {
+        if constexpr (relocatable) {
+            return emplace(pos, value);
+        }
+        if (reserve_moves_elements(v_size + 1)) {
+            value_type copy(value);
+            reserve(v_size + 1);
+            return insert(pos, std::move(copy));
+        }
         elements_shift(pos - begin(), 1);
         if (pos == end()) {
-            new (get_ptr_by_index(v_size)) value_type(value);
+            new (get_ptr_by_index(pos - begin())) value_type(value);
         } else {
             operator[](pos - begin()) = value;
         }
@@ -594,9 +1209,17 @@ public:
     }
 
     iterator insert(const_iterator pos, rvalue_reference value) & {
+        if constexpr (relocatable) {
+            return emplace(pos, std::move(value));
+        }
+        if (reserve_moves_elements(v_size + 1)) {
+            value_type moved(std::move(value));
+            reserve(v_size + 1);
+            return insert(pos, std::move(moved));
+        }
         elements_shift(pos - begin(), 1);
         if (pos == end()) {
-            new (get_ptr_by_index(v_size)) value_type(std::move(value));
+            new (get_ptr_by_index(pos - begin())) value_type(std::move(value));
         } else {
             operator[](pos - begin()) = std::move(value);
         }
@@ -606,7 +1229,18 @@ public:
 
     iterator insert(const_iterator pos, size_type count, const_reference value)
         & {
+        if (reserve_moves_elements(v_size + count)) {
+            const value_type copy(value);
+            reserve(v_size + count);
+            return insert(pos, count, copy);
+        }
         elements_shift(pos - begin(), count);
+        if constexpr (relocatable) {
+            construct_in_gap(pos - begin(), count, [&value](pointer p) {
+                new (p) value_type(value);
+            });
+            return iterator(this, pos - begin());
+        }
         for (size_type current_pos = pos - begin();
              current_pos < count + (pos - begin()); ++current_pos) {
             if (current_pos >= v_size) {
@@ -627,8 +1261,30 @@ public:
                 typename std::iterator_traits<InputIt>::iterator_category>,
             bool> = true>
     iterator insert(const_iterator pos, InputIt first, InputIt last) & {
+        if constexpr (!is_random_access_iterator_v<InputIt>) {
+            // One pass: append the range, then rotate it into place.
+            const difference_type index = pos - begin();
+            const size_type old_size = v_size;
+            try {
+                append_range(first, last);
+            } catch (...) {
+                while (v_size > old_size) {
+                    pop_back();
+                }
+                throw;
+            }
+            std::rotate(begin() + index, begin() + old_size, end());
+            return iterator(this, index);
+        }
         size_type count = std::distance(first, last);
         elements_shift(pos - begin(), count);
+        if constexpr (relocatable) {
+            construct_in_gap(pos - begin(), count, [&first](pointer p) {
+                new (p) value_type(*first);
+                ++first;
+            });
+            return iterator(this, pos - begin());
+        }
         for (size_type current_pos = pos - begin();
              current_pos < count + (pos - begin()); ++current_pos) {
             if (current_pos >= v_size) {
@@ -649,10 +1305,34 @@ public:
 
     template <class... Args>
     iterator emplace(const_iterator pos, Args &&...args) {
+        if constexpr (relocatable) {
+            // Built aside first, so a throwing constructor changes nothing.
+            const size_type index = pos - begin();
+            alignas(value_type) unsigned char buffer[sizeof(value_type)];
+            pointer value = reinterpret_cast<pointer>(buffer);
+            this->construct(value, std::forward<Args>(args)...);
+            try {
+                elements_shift(index, 1);
+            } catch (...) {
+                std::destroy_at(value);
+                throw;
+            }
+            std::memcpy(
+                static_cast<void *>(get_ptr_by_index(index)),
+                static_cast<const void *>(value), sizeof(T)
+            );
+            ++v_size;
+            return iterator(this, index);
+        }
+        if (reserve_moves_elements(v_size + 1)) {
+            value_type value(std::forward<Args>(args)...);
+            reserve(v_size + 1);
+            return emplace(pos, std::move(value));
+        }
         elements_shift(pos - begin(), 1);
         if (pos == end()) {
             this->construct(
-                get_ptr_by_index(v_size), std::forward<Args>(args)...
+                get_ptr_by_index(pos - begin()), std::forward<Args>(args)...
             );
         } else {
             operator[](pos - begin()) = value_type(std::forward<Args>(args)...);
@@ -662,12 +1342,26 @@ public:
     }
 
     iterator erase(const_iterator pos) {
+        if constexpr (relocatable) {
+            operator[](pos - begin()).~value_type();
+            elements_shift(pos - begin() + 1, -1);
+            --v_size;
+            return iterator(this, pos - begin());
+        }
         elements_shift(pos - begin() + 1, -1);
         operator[](--v_size).~value_type();
         return iterator(this, pos - begin());
     }
 
     iterator erase(const_iterator first, const_iterator last) {
+        if constexpr (relocatable) {
+            for (difference_type i = first - begin(); i < last - begin(); ++i) {
+                operator[](i).~value_type();
+            }
+            elements_shift(last - begin(), first - last);
+            v_size -= last - first;
+            return iterator(this, first - begin());
+        }
         elements_shift(last - begin(), first - last);
         for (size_type i = 0; i < static_cast<size_type>(last - first); ++i) {
             operator[](--v_size).~value_type();
@@ -675,13 +1369,26 @@ public:
         return iterator(this, first - begin());
     }
 
+    // The argument may be an element of the first chunk that grows.
     void push_back(const_reference t) & {
+        if (reserve_moves_elements(v_size + 1)) {
+            append_growing_first_chunk([&t](pointer p) {
+                new (p) value_type(t);
+            });
+            return;
+        }
         reserve(v_size + 1);
         pointer pos_for_new_value = get_ptr_by_index(v_size++);
         new (pos_for_new_value) value_type(t);
     }
 
     void push_back(rvalue_reference t) & {
+        if (reserve_moves_elements(v_size + 1)) {
+            append_growing_first_chunk([&t](pointer p) {
+                new (p) value_type(std::move(t));
+            });
+            return;
+        }
         reserve(v_size + 1);
         pointer pos_for_new_value = get_ptr_by_index(v_size++);
         new (pos_for_new_value) value_type(std::move(t));
@@ -689,6 +1396,12 @@ public:
 
     template <class... Args>
     reference emplace_back(Args &&...args) {
+        if (reserve_moves_elements(v_size + 1)) {
+            append_growing_first_chunk([&](pointer p) {
+                this->construct(p, std::forward<Args>(args)...);
+            });
+            return back();
+        }
         reserve(v_size + 1);
         pointer pos_for_new_value = get_ptr_by_index(v_size++);
         this->construct(pos_for_new_value, std::forward<Args>(args)...);
@@ -703,23 +1416,40 @@ public:
         while (count < v_size) {
             pop_back();
         }
-        reserve(count);
-        while (count > v_size) {
-            push_back(T());
+        if (count > v_size) {
+            append_uninitialized(count - v_size, [](pointer data, size_type n) {
+                std::uninitialized_value_construct_n(data, n);
+            });
         }
     }
 
     void resize(size_type count, const_reference t) & {
+        if (reserve_moves_elements(count)) {
+            const value_type copy(t);
+            reserve(count);
+            resize(count, copy);
+            return;
+        }
         while (count < v_size) {
             pop_back();
         }
-        reserve(count);
-        while (count > v_size) {
-            push_back(t);
+        if (count > v_size) {
+            append_uninitialized(
+                count - v_size,
+                [&t](pointer data, size_type n) {
+                    std::uninitialized_fill_n(data, n, t);
+                }
+            );
         }
     }
 
     void resize(size_type count, rvalue_reference t) & {
+        if (reserve_moves_elements(count)) {
+            value_type moved(std::move(t));
+            reserve(count);
+            resize(count, std::move(moved));
+            return;
+        }
         while (count < v_size) {
             pop_back();
         }
@@ -735,6 +1465,186 @@ public:
     void swap(chunk_vector &other) noexcept {
         v_chunks.swap(other.v_chunks);
         std::swap(v_size, other.v_size);
+        const size_type first_capacity = this->first_chunk_capacity();
+        this->set_first_chunk_capacity(other.first_chunk_capacity());
+        other.set_first_chunk_capacity(first_capacity);
+    }
+
+    // Bulk append
+    // Appends count elements that f(data, n) constructs a chunk at a time.
+    template <class F>
+    void append_uninitialized(size_type count, F f) & {
+        reserve(v_size + count);
+        while (count > 0) {
+            const size_type n =
+                std::min(count, chunk_size - v_size % chunk_size);
+            f(get_ptr_by_index(v_size), n);
+            v_size += n;
+            count -= n;
+        }
+    }
+
+    // Appends count default-initialized elements and returns their spans.
+    span_range grow_by(size_type count) & {
+        const size_type first = v_size;
+        append_uninitialized(count, [](pointer data, size_type n) {
+            std::uninitialized_default_construct_n(data, n);
+        });
+        return span_range(this, first, v_size);
+    }
+
+    // Appends copies of [first, last) a chunk at a time, in a single pass.
+    template <
+        class InputIt,
+        std::enable_if_t<
+            std::is_base_of_v<
+                std::input_iterator_tag,
+                typename std::iterator_traits<InputIt>::iterator_category>,
+            bool> = true>
+    void append_range(InputIt first, InputIt last) & {
+        if constexpr (is_random_access_iterator_v<InputIt>) {
+            append_uninitialized(
+                std::distance(first, last),
+                [&first](pointer data, size_type n) {
+                    const InputIt run_last = std::next(first, n);
+                    std::uninitialized_copy(first, run_last, data);
+                    first = run_last;
+                }
+            );
+        } else {
+            while (first != last) {
+                reserve(v_size + 1);
+                const size_type run = std::min(
+                    capacity() - v_size, chunk_size - v_size % chunk_size
+                );
+                const pointer data = get_ptr_by_index(v_size);
+                for (size_type i = 0; i < run && first != last;
+                     ++i, ++first) {
+                    this->construct(data + i, *first);
+                    ++v_size;
+                }
+            }
+        }
+    }
+
+    // Appends up to count elements read from is as raw bytes; returns how
+    // many were appended.
+    size_type read_from(std::istream &is, size_type count) & {
+        static_assert(
+            std::is_trivially_copyable_v<T>,
+            "read_from requires trivially copyable elements"
+        );
+        const size_type old_size = v_size;
+        while (count > 0) {
+            const size_type n =
+                std::min(count, chunk_size - v_size % chunk_size);
+            reserve(v_size + n);
+            is.read(
+                reinterpret_cast<char *>(get_ptr_by_index(v_size)),
+                static_cast<std::streamsize>(n * sizeof(T))
+            );
+            const size_type read =
+                static_cast<size_type>(is.gcount()) / sizeof(T);
+            v_size += read;
+            count -= read;
+            if (read < n) {
+                break;
+            }
+        }
+        return v_size - old_size;
+    }
+
+    // Chunk transfer
+    // Moves all elements of other to the end, taking over whole chunks.
+    void append(chunk_vector &&other) & {
+        if (this == &other || other.v_size == 0) {
+            return;
+        }
+        if (v_size % chunk_size != 0 || !has_full_chunks() ||
+            !other.has_full_chunks() || !shares_chunks_with(other)) {
+            move_append(other, 0);
+            return;
+        }
+        // Spare chunks of other come along only if the table has room.
+        const size_type room = v_chunks.max_size() - v_chunks.size();
+        const size_type moved = other.v_chunks.size() <= room
+                                    ? other.v_chunks.size()
+                                    : other.chunk_count();
+        v_chunks.insert(
+            v_chunks.begin() + chunk_count(), other.v_chunks.begin(),
+            other.v_chunks.begin() + moved
+        );
+        other.v_chunks.erase(
+            other.v_chunks.begin(), other.v_chunks.begin() + moved
+        );
+        v_size += std::exchange(other.v_size, 0);
+    }
+
+    // Moves all elements of other before pos, taking over whole chunks.
+    iterator splice(const_iterator pos, chunk_vector &&other) & {
+        const size_type index = pos - cbegin();
+        if (this == &other) {
+            return iterator(this, index);
+        }
+        if (index == v_size) {
+            append(std::move(other));
+            return iterator(this, index);
+        }
+        if (index % chunk_size != 0 ||
+            other.v_size % chunk_size != 0 || !has_full_chunks() ||
+            !other.has_full_chunks() || !shares_chunks_with(other)) {
+            if constexpr (relocatable) {
+                elements_shift(index, other.v_size);
+                relocate_elements(other, 0, index, other.v_size);
+                v_size += std::exchange(other.v_size, 0);
+                return iterator(this, index);
+            }
+            insert(
+                pos, std::make_move_iterator(other.begin()),
+                std::make_move_iterator(other.end())
+            );
+            other.clear();
+            return iterator(this, index);
+        }
+        // Spare chunks of other go to the end if the table has room.
+        const size_type used = other.chunk_count();
+        const size_type room = v_chunks.max_size() - v_chunks.size();
+        const size_type moved =
+            other.v_chunks.size() <= room ? other.v_chunks.size() : used;
+        const size_type at = index / chunk_size;
+        v_chunks.insert(
+            v_chunks.begin() + at, other.v_chunks.begin(),
+            other.v_chunks.begin() + moved
+        );
+        const auto spare = v_chunks.begin() + (at + used);
+        std::rotate(spare, spare + (moved - used), v_chunks.end());
+        other.v_chunks.erase(
+            other.v_chunks.begin(), other.v_chunks.begin() + moved
+        );
+        v_size += std::exchange(other.v_size, 0);
+        return iterator(this, index);
+    }
+
+    // Removes the elements [index, size()) and returns them as a new vector.
+    chunk_vector split_at(size_type index) & {
+        if (index > v_size) {
+            throw std::out_of_range(
+                "Requested split index: " + std::to_string(index) +
+                ", size: " + std::to_string(v_size)
+            );
+        }
+        chunk_vector tail(get_allocator());
+        if (index % chunk_size != 0 || !has_full_chunks()) {
+            tail.move_append(*this, index);
+            return tail;
+        }
+        const auto first = v_chunks.begin() + index / chunk_size;
+        const auto last = v_chunks.begin() + chunk_count();
+        tail.v_chunks.assign(first, last);
+        v_chunks.erase(first, last);
+        tail.v_size = v_size - index;
+        v_size = index;
+        return tail;
     }
 
     // Friend functions
@@ -747,13 +1657,17 @@ public:
         return it + n;
     }
 
+    // Compared chunk by chunk on raw pointers.
     friend bool
     operator==(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
         if (lhs.size() != rhs.size()) {
             return false;
         }
-        for (size_type i = 0; i < lhs.size(); ++i) {
-            if (lhs[i] != rhs[i]) {
+        for (size_type chunk = 0; chunk < lhs.chunk_count(); ++chunk) {
+            if (!equal_chunks(
+                    lhs.v_chunks[chunk], rhs.v_chunks[chunk],
+                    lhs.chunk_length(chunk)
+                )) {
                 return false;
             }
         }
@@ -765,18 +1679,29 @@ public:
         return !(lhs == rhs);
     }
 
-    friend bool
-    operator<(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
-        size_type min_size = std::min(lhs.size(), rhs.size());
-        for (size_type i = 0; i < min_size; ++i) {
-            if (lhs[i] < rhs[i]) {
-                return true;
-            }
-            if (lhs[i] > rhs[i]) {
-                return false;
+    // Three-way lexicographical comparison in a single pass.
+    friend int
+    compare(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        const size_type min_size = std::min(lhs.size(), rhs.size());
+        for (size_type start = 0, chunk = 0; start < min_size;
+             start += chunk_size, ++chunk) {
+            const int result = compare_chunks(
+                lhs.v_chunks[chunk], rhs.v_chunks[chunk],
+                std::min(chunk_size, min_size - start)
+            );
+            if (result != 0) {
+                return result;
             }
         }
-        return lhs.size() < rhs.size();
+        if (lhs.size() == rhs.size()) {
+            return 0;
+        }
+        return lhs.size() < rhs.size() ? -1 : 1;
+    }
+
+    friend bool
+    operator<(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        return compare(lhs, rhs) < 0;
     }
 
     friend bool
@@ -797,13 +1722,33 @@ public:
 }  // namespace CustomVector
 
 namespace std {
-template <typename T, std::size_t chunk_size, typename Alloc>
+template <
+    typename T,
+    std::size_t chunk_size,
+    typename Alloc,
+    std::size_t first_chunk_size,
+    typename ChunkTable,
+    typename Packing>
 void swap(
-    CustomVector::chunk_vector<T, chunk_size, Alloc> &lhs,
-    CustomVector::chunk_vector<T, chunk_size, Alloc> &rhs
+    CustomVector::chunk_vector<
+        T,
+        chunk_size,
+        Alloc,
+        first_chunk_size,
+        ChunkTable,
+        Packing> &lhs,
+    CustomVector::chunk_vector<
+        T,
+        chunk_size,
+        Alloc,
+        first_chunk_size,
+        ChunkTable,
+        Packing> &rhs
 ) noexcept {
     lhs.swap(rhs);
 }
 }  // namespace std
 
+#include "chunk_vector_bool.hpp"
+
 #endif  // CHUNK_VECTOR_HPP
@@ -0,0 +1,923 @@
+#ifndef CHUNK_VECTOR_BOOL_HPP
+#define CHUNK_VECTOR_BOOL_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "chunk_algorithms.hpp"
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+// chunk_vector<bool> packs chunk_size elements into chunk_size / 64 words
+// per chunk and, like std::vector<bool>, hands out proxy references. Bits
+// past size() are kept zero, so count(), find_first()/find_next() and the
+// bitwise operators work on whole words, with the SIMD kernels of
+// chunk_algorithms.hpp. Bitwise operators need vectors of the same size.
+// insert and erase move the following elements by whole words. Shapes that
+// cannot be packed (chunk_size not a multiple of 64, or an adaptive first
+// chunk) use the generic chunk_vector. The chunk transfer and batched
+// access members of the generic chunk_vector are not provided, and
+// chunk_words replaces chunk_data.
+//
+//     chunk_vector<bool> visited(n);
+//     visited[i] = true;
+//     for (auto i = visited.find_first(); i != visited.npos;
+//          i = visited.find_next(i)) { ... }
+template <
+    std::size_t chunk_size,
+    typename Alloc,
+    std::size_t first_chunk_size,
+    typename ChunkTable>
+class chunk_vector<
+    bool,
+    chunk_size,
+    Alloc,
+    first_chunk_size,
+    ChunkTable,
+    std::enable_if_t<chunk_size % 64 == 0 && first_chunk_size == chunk_size>>
+    : private alloc_wrapper<
+          std::uint64_t,
+          typename std::allocator_traits<Alloc>::template rebind_alloc<
+              std::uint64_t>,
+          void> {
+public:
+    // Member types
+    using value_type = bool;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = bool;
+    using word_type = std::uint64_t;
+
+    static constexpr size_type bits_per_word = 64;
+    static constexpr size_type words_per_chunk = chunk_size / bits_per_word;
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    class reference {
+    private:
+        friend class chunk_vector;
+
+        word_type *r_word;
+        word_type r_mask;
+
+        reference(word_type *word, word_type mask) noexcept
+            : r_word(word), r_mask(mask) {
+        }
+
+    public:
+        reference(const reference &) = default;
+
+        operator bool() const noexcept {
+            return (*r_word & r_mask) != 0;
+        }
+
+        reference &operator=(bool value) noexcept {
+            if (value) {
+                *r_word |= r_mask;
+            } else {
+                *r_word &= ~r_mask;
+            }
+            return *this;
+        }
+
+        reference &operator=(const reference &other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+        bool operator~() const noexcept {
+            return !static_cast<bool>(*this);
+        }
+
+        void flip() noexcept {
+            *r_word ^= r_mask;
+        }
+
+        friend void swap(reference lhs, reference rhs) noexcept {
+            const bool value = lhs;
+            lhs = static_cast<bool>(rhs);
+            rhs = value;
+        }
+    };
+
+private:
+    using word_alloc_wrapper = alloc_wrapper<
+        word_type,
+        typename std::allocator_traits<Alloc>::template rebind_alloc<
+            word_type>,
+        void>;
+    using chunk_table = typename ChunkTable::template table<word_type *>;
+
+    template <bool is_const>
+    class bit_iterator {
+    private:
+        using Owner =
+            std::conditional_t<is_const, const chunk_vector, chunk_vector>;
+        Owner *m_owner;
+        size_type m_index;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::
+            conditional_t<is_const, bool, typename chunk_vector::reference>;
+
+        bit_iterator() noexcept : m_owner(nullptr), m_index(0) {
+        }
+
+        bit_iterator(Owner *owner, size_type index) noexcept
+            : m_owner(owner), m_index(index) {
+        }
+
+        operator bit_iterator<true>() const noexcept {
+            return bit_iterator<true>(m_owner, m_index);
+        }
+
+        reference operator*() const noexcept {
+            return (*m_owner)[m_index];
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return (*m_owner)[m_index + n];
+        }
+
+        bit_iterator &operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+
+        bit_iterator operator++(int) noexcept {
+            bit_iterator copy = *this;
+            ++m_index;
+            return copy;
+        }
+
+        bit_iterator &operator--() noexcept {
+            --m_index;
+            return *this;
+        }
+
+        bit_iterator operator--(int) noexcept {
+            bit_iterator copy = *this;
+            --m_index;
+            return copy;
+        }
+
+        bit_iterator &operator+=(difference_type n) noexcept {
+            m_index += n;
+            return *this;
+        }
+
+        bit_iterator &operator-=(difference_type n) noexcept {
+            m_index -= n;
+            return *this;
+        }
+
+        bit_iterator operator+(difference_type n) const noexcept {
+            return bit_iterator(m_owner, m_index + n);
+        }
+
+        friend bit_iterator
+        operator+(difference_type n, const bit_iterator &it) noexcept {
+            return it + n;
+        }
+
+        bit_iterator operator-(difference_type n) const noexcept {
+            return bit_iterator(m_owner, m_index - n);
+        }
+
+        difference_type operator-(const bit_iterator &other) const noexcept {
+            return static_cast<difference_type>(m_index) -
+                   static_cast<difference_type>(other.m_index);
+        }
+
+        bool operator==(const bit_iterator &other) const noexcept {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const bit_iterator &other) const noexcept {
+            return m_index != other.m_index;
+        }
+
+        bool operator<(const bit_iterator &other) const noexcept {
+            return m_index < other.m_index;
+        }
+
+        bool operator>(const bit_iterator &other) const noexcept {
+            return m_index > other.m_index;
+        }
+
+        bool operator<=(const bit_iterator &other) const noexcept {
+            return m_index <= other.m_index;
+        }
+
+        bool operator>=(const bit_iterator &other) const noexcept {
+            return m_index >= other.m_index;
+        }
+    };
+
+    size_type v_size = 0;
+    chunk_table v_chunks;
+
+    [[nodiscard]] word_type *word_of(size_type pos) const noexcept {
+        return v_chunks[pos / chunk_size] + pos % chunk_size / bits_per_word;
+    }
+
+    static word_type mask_of(size_type pos) noexcept {
+        return word_type(1) << (pos % bits_per_word);
+    }
+
+    // Words of chunk that hold elements.
+    [[nodiscard]] size_type words_in_use(size_type chunk) const noexcept {
+        return (chunk_length(chunk) + bits_per_word - 1) / bits_per_word;
+    }
+
+    static void
+    apply_mask(word_type &word, word_type mask, bool value) noexcept {
+        if (value) {
+            word |= mask;
+        } else {
+            word &= ~mask;
+        }
+    }
+
+    // Sets the bits [from, to) of one chunk to value.
+    static void
+    fill_bits(word_type *words, size_type from, size_type to, bool value)
+        noexcept {
+        if (from == to) {
+            return;
+        }
+        const size_type first = from / bits_per_word;
+        const size_type last = (to - 1) / bits_per_word;
+        const word_type head = ~word_type(0) << (from % bits_per_word);
+        const word_type tail =
+            ~word_type(0) >> (bits_per_word - 1 - (to - 1) % bits_per_word);
+        if (first == last) {
+            apply_mask(words[first], head & tail, value);
+            return;
+        }
+        apply_mask(words[first], head, value);
+        std::fill(
+            words + first + 1, words + last, value ? ~word_type(0) : 0
+        );
+        apply_mask(words[last], tail, value);
+    }
+
+    void check_out_of_bound(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range(
+                "Requested index: " + std::to_string(index) +
+                ", size: " + std::to_string(size())
+            );
+        }
+    }
+
+    void check_same_size(const chunk_vector &other) const {
+        if (other.v_size != v_size) {
+            throw std::invalid_argument(
+                "chunk_vector<bool>: sizes differ: " + std::to_string(v_size) +
+                " and " + std::to_string(other.v_size)
+            );
+        }
+    }
+
+    template <class Kernel>
+    chunk_vector &apply_words(const chunk_vector &other, Kernel kernel) {
+        check_same_size(other);
+        for (size_type i = 0; i < chunk_count(); ++i) {
+            kernel(v_chunks[i], other.v_chunks[i], words_in_use(i));
+        }
+        return *this;
+    }
+
+    // First set bit at or after pos, or npos.
+    [[nodiscard]] size_type find_from(size_type pos) const noexcept {
+        if (pos >= v_size) {
+            return npos;
+        }
+        size_type chunk = pos / chunk_size;
+        size_type word = pos % chunk_size / bits_per_word;
+        word_type bits = v_chunks[chunk][word] & (~word_type(0) << (pos % 64));
+        for (;;) {
+            if (bits != 0) {
+                return chunk * chunk_size + word * bits_per_word +
+                       static_cast<size_type>(__builtin_ctzll(bits));
+            }
+            if (++word == words_in_use(chunk)) {
+                if (++chunk == chunk_count()) {
+                    return npos;
+                }
+                word = 0;
+            }
+            bits = v_chunks[chunk][word];
+        }
+    }
+
+    static word_type low_bits(size_type count) noexcept {
+        return count == bits_per_word ? ~word_type(0)
+                                      : (word_type(1) << count) - 1;
+    }
+
+    // count <= 64 bits starting at pos, which may span two words.
+    [[nodiscard]] word_type
+    read_bits(size_type pos, size_type count) const noexcept {
+        const size_type offset = pos % bits_per_word;
+        word_type bits = *word_of(pos) >> offset;
+        if (offset + count > bits_per_word) {
+            bits |= *word_of(pos + bits_per_word - offset)
+                    << (bits_per_word - offset);
+        }
+        return bits & low_bits(count);
+    }
+
+    void write_bits(size_type pos, size_type count, word_type bits) noexcept {
+        const size_type offset = pos % bits_per_word;
+        const word_type mask = low_bits(count);
+        bits &= mask;
+        word_type &first = *word_of(pos);
+        first = (first & ~(mask << offset)) | (bits << offset);
+        if (offset + count > bits_per_word) {
+            const size_type written = bits_per_word - offset;
+            word_type &second = *word_of(pos + written);
+            second = (second & ~(mask >> written)) | (bits >> written);
+        }
+    }
+
+    // Copies the bits [from, from + count) to [to, to + count) a word at a
+    // time; the ranges may overlap.
+    void move_bits(size_type from, size_type to, size_type count) noexcept {
+        if (to < from) {
+            for (size_type done = 0; done < count; done += bits_per_word) {
+                const size_type n = std::min(bits_per_word, count - done);
+                write_bits(to + done, n, read_bits(from + done, n));
+            }
+        } else if (to > from) {
+            for (size_type left = count; left > 0;) {
+                const size_type n = std::min(bits_per_word, left);
+                left -= n;
+                write_bits(to + left, n, read_bits(from + left, n));
+            }
+        }
+    }
+
+    // Moves the elements from index on count places up; the bits of the gap
+    // keep their old values.
+    void open_gap(size_type index, size_type count) {
+        if (count > max_size() - v_size) {
+            throw std::length_error(
+                "Requested size: " + std::to_string(v_size) + " + " +
+                std::to_string(count) +
+                ", max_size: " + std::to_string(max_size())
+            );
+        }
+        reserve(v_size + count);
+        move_bits(index, index + count, v_size - index);
+        v_size += count;
+    }
+
+public:
+    using iterator = bit_iterator<false>;
+    using const_iterator = bit_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    chunk_vector() noexcept(noexcept(chunk_table())) = default;
+
+    explicit chunk_vector(const allocator_type &alloc)
+        : word_alloc_wrapper(typename std::allocator_traits<
+                             Alloc>::template rebind_alloc<word_type>(alloc)) {
+    }
+
+    explicit chunk_vector(
+        size_type count,
+        const allocator_type &alloc = allocator_type()
+    )
+        : chunk_vector(alloc) {
+        resize(count);
+    }
+
+    chunk_vector(
+        size_type count,
+        bool value,
+        const allocator_type &alloc = allocator_type()
+    )
+        : chunk_vector(alloc) {
+        resize(count, value);
+    }
+
+    template <
+        class InputIt,
+        std::enable_if_t<
+            std::is_base_of_v<
+                std::input_iterator_tag,
+                typename std::iterator_traits<InputIt>::iterator_category>,
+            bool> = true>
+    chunk_vector(
+        InputIt first,
+        InputIt last,
+        const allocator_type &alloc = allocator_type()
+    )
+        : chunk_vector(alloc) {
+        if constexpr (std::is_base_of_v<
+                          std::random_access_iterator_tag,
+                          typename std::iterator_traits<
+                              InputIt>::iterator_category>) {
+            reserve(static_cast<size_type>(last - first));
+        }
+        for (; first != last; ++first) {
+            push_back(static_cast<bool>(*first));
+        }
+    }
+
+    chunk_vector(
+        std::initializer_list<bool> init,
+        const allocator_type &alloc = allocator_type()
+    )
+        : chunk_vector(init.begin(), init.end(), alloc) {
+    }
+
+    chunk_vector(const chunk_vector &other)
+        : chunk_vector(std::allocator_traits<allocator_type>::
+                           select_on_container_copy_construction(
+                               other.get_allocator()
+                           )) {
+        reserve(other.v_size);
+        for (size_type i = 0; i < other.chunk_count(); ++i) {
+            std::copy_n(other.v_chunks[i], other.words_in_use(i), v_chunks[i]);
+        }
+        v_size = other.v_size;
+    }
+
+    chunk_vector(chunk_vector &&other) noexcept
+        : word_alloc_wrapper(std::move(other.get_alloc_ref())),
+          v_size(std::exchange(other.v_size, 0)),
+          v_chunks(std::move(other.v_chunks)) {
+        other.v_chunks.clear();
+    }
+
+    chunk_vector &operator=(const chunk_vector &other) {
+        if (this != &other) {
+            chunk_vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    chunk_vector &operator=(chunk_vector &&other) noexcept {
+        if (this != &other) {
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~chunk_vector() {
+        for (word_type *chunk : v_chunks) {
+            this->deallocate(chunk, words_per_chunk);
+        }
+    }
+
+    void assign(size_type count, bool value) {
+        clear();
+        resize(count, value);
+    }
+
+    template <
+        class InputIt,
+        std::enable_if_t<
+            std::is_base_of_v<
+                std::input_iterator_tag,
+                typename std::iterator_traits<InputIt>::iterator_category>,
+            bool> = true>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        insert(cend(), first, last);
+    }
+
+    void assign(std::initializer_list<bool> ilist) {
+        assign(ilist.begin(), ilist.end());
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(this->get_alloc_copy());
+    }
+
+    // Element access
+    reference operator[](size_type pos) noexcept {
+        return reference(word_of(pos), mask_of(pos));
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        return (*word_of(pos) & mask_of(pos)) != 0;
+    }
+
+    reference at(size_type pos) {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    [[nodiscard]] const_reference at(size_type pos) const {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    reference front() noexcept {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] const_reference front() const noexcept {
+        return (*this)[0];
+    }
+
+    reference back() noexcept {
+        return (*this)[v_size - 1];
+    }
+
+    [[nodiscard]] const_reference back() const noexcept {
+        return (*this)[v_size - 1];
+    }
+
+    // Chunk access
+    [[nodiscard]] size_type chunk_count() const noexcept {
+        return (v_size + chunk_size - 1) / chunk_size;
+    }
+
+    // The words of chunk; bit j of word w is element
+    // chunk * chunk_size + w * 64 + j.
+    word_type *chunk_words(size_type chunk) noexcept {
+        return v_chunks[chunk];
+    }
+
+    [[nodiscard]] const word_type *chunk_words(size_type chunk
+    ) const noexcept {
+        return v_chunks[chunk];
+    }
+
+    // Elements in chunk.
+    [[nodiscard]] size_type chunk_length(size_type chunk) const noexcept {
+        return std::min(chunk_size, v_size - chunk * chunk_size);
+    }
+
+    // Iterators
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(this, v_size);
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(this, v_size);
+    }
+
+    [[nodiscard]] const_iterator cend() const noexcept {
+        return end();
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator(end());
+    }
+
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator(begin());
+    }
+
+    [[nodiscard]] const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    // Capacity
+    [[nodiscard]] bool empty() const noexcept {
+        return v_size == 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return v_size;
+    }
+
+    [[nodiscard]] size_type max_size() const noexcept {
+        if constexpr (std::is_same_v<chunk_table, std::vector<word_type *>>) {
+            return std::numeric_limits<size_type>::max();
+        } else {
+            return std::min(
+                chunk_table::max_size(),
+                std::numeric_limits<size_type>::max() / chunk_size
+            ) * chunk_size;
+        }
+    }
+
+    // New chunks are zeroed, which keeps the bits past size() clear.
+    void reserve(size_type k) {
+        if (k > max_size()) {
+            throw std::length_error(
+                "Requested capacity: " + std::to_string(k) +
+                ", max_size: " + std::to_string(max_size())
+            );
+        }
+        while (capacity() < k) {
+            word_type *chunk = this->allocate(words_per_chunk);
+            std::fill_n(chunk, words_per_chunk, word_type(0));
+            try {
+                v_chunks.push_back(chunk);
+            } catch (...) {
+                this->deallocate(chunk, words_per_chunk);
+                throw;
+            }
+        }
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return v_chunks.size() * chunk_size;
+    }
+
+    void shrink_to_fit() {
+        while (v_chunks.size() > chunk_count()) {
+            this->deallocate(v_chunks.back(), words_per_chunk);
+            v_chunks.pop_back();
+        }
+        v_chunks.shrink_to_fit();
+    }
+
+    // Word-level operations
+    // Number of elements that are true.
+    [[nodiscard]] size_type count() const noexcept {
+        size_type result = 0;
+        for (size_type i = 0; i < chunk_count(); ++i) {
+            result += simd::count_bits(v_chunks[i], words_in_use(i));
+        }
+        return result;
+    }
+
+    // Index of the first true element, or npos.
+    [[nodiscard]] size_type find_first() const noexcept {
+        return find_from(0);
+    }
+
+    // Index of the first true element after pos, or npos.
+    [[nodiscard]] size_type find_next(size_type pos) const noexcept {
+        return pos >= v_size ? npos : find_from(pos + 1);
+    }
+
+    // Sets the elements [first, last) to value, a chunk at a time.
+    void fill(size_type first, size_type last, bool value) noexcept {
+        while (first < last) {
+            const size_type chunk = first / chunk_size;
+            const size_type chunk_last =
+                std::min(last, (chunk + 1) * chunk_size);
+            fill_bits(
+                v_chunks[chunk], first % chunk_size,
+                chunk_last - chunk * chunk_size, value
+            );
+            first = chunk_last;
+        }
+    }
+
+    void fill(bool value) noexcept {
+        fill(0, v_size, value);
+    }
+
+    // Negates every element.
+    void flip() noexcept {
+        fill_bits_past_size(true);
+        for (size_type i = 0; i < chunk_count(); ++i) {
+            for (size_type w = 0; w < words_in_use(i); ++w) {
+                v_chunks[i][w] = ~v_chunks[i][w];
+            }
+        }
+    }
+
+    chunk_vector &operator&=(const chunk_vector &other) {
+        return apply_words(other, [](auto... args) {
+            simd::and_words(args...);
+        });
+    }
+
+    chunk_vector &operator|=(const chunk_vector &other) {
+        return apply_words(other, [](auto... args) {
+            simd::or_words(args...);
+        });
+    }
+
+    chunk_vector &operator^=(const chunk_vector &other) {
+        return apply_words(other, [](auto... args) {
+            simd::xor_words(args...);
+        });
+    }
+
+    friend chunk_vector operator&(chunk_vector lhs, const chunk_vector &rhs) {
+        lhs &= rhs;
+        return lhs;
+    }
+
+    friend chunk_vector operator|(chunk_vector lhs, const chunk_vector &rhs) {
+        lhs |= rhs;
+        return lhs;
+    }
+
+    friend chunk_vector operator^(chunk_vector lhs, const chunk_vector &rhs) {
+        lhs ^= rhs;
+        return lhs;
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        fill(false);
+        v_size = 0;
+    }
+
+    // The elements after pos are moved by whole words.
+    iterator insert(const_iterator pos, bool value) {
+        return insert(pos, 1, value);
+    }
+
+    iterator insert(const_iterator pos, size_type count, bool value) {
+        const size_type index = pos - cbegin();
+        open_gap(index, count);
+        fill(index, index + count, value);
+        return iterator(this, index);
+    }
+
+    template <
+        class InputIt,
+        std::enable_if_t<
+            std::is_base_of_v<
+                std::input_iterator_tag,
+                typename std::iterator_traits<InputIt>::iterator_category>,
+            bool> = true>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        const size_type index = pos - cbegin();
+        if constexpr (!std::is_base_of_v<
+                          std::forward_iterator_tag,
+                          typename std::iterator_traits<
+                              InputIt>::iterator_category>) {
+            // One pass: the range is packed aside, then copied word by word.
+            const chunk_vector bits(first, last, get_allocator());
+            open_gap(index, bits.v_size);
+            for (size_type done = 0; done < bits.v_size;
+                 done += bits_per_word) {
+                const size_type n = std::min(bits_per_word, bits.v_size - done);
+                write_bits(index + done, n, bits.read_bits(done, n));
+            }
+        } else {
+            open_gap(index, static_cast<size_type>(std::distance(first, last)));
+            for (size_type i = index; first != last; ++first, ++i) {
+                apply_mask(*word_of(i), mask_of(i), static_cast<bool>(*first));
+            }
+        }
+        return iterator(this, index);
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<bool> ilist) {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+
+    iterator emplace(const_iterator pos, bool value) {
+        return insert(pos, value);
+    }
+
+    iterator erase(const_iterator pos) noexcept {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept {
+        const size_type index = first - cbegin();
+        const size_type count = last - first;
+        move_bits(index + count, index, v_size - index - count);
+        fill(v_size - count, v_size, false);
+        v_size -= count;
+        return iterator(this, index);
+    }
+
+    void push_back(bool value) {
+        if (v_size == capacity()) {
+            reserve(v_size + 1);
+        }
+        if (value) {
+            *word_of(v_size) |= mask_of(v_size);
+        }
+        ++v_size;
+    }
+
+    reference emplace_back(bool value) {
+        push_back(value);
+        return back();
+    }
+
+    void pop_back() noexcept {
+        --v_size;
+        *word_of(v_size) &= ~mask_of(v_size);
+    }
+
+    void resize(size_type count, bool value = false) {
+        if (count < v_size) {
+            fill(count, v_size, false);
+        } else {
+            reserve(count);
+            if (value) {
+                fill(v_size, count, true);
+            }
+        }
+        v_size = count;
+    }
+
+    void swap(chunk_vector &other) noexcept {
+        v_chunks.swap(other.v_chunks);
+        std::swap(v_size, other.v_size);
+    }
+
+    friend bool
+    operator==(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        if (lhs.v_size != rhs.v_size) {
+            return false;
+        }
+        for (size_type i = 0; i < lhs.chunk_count(); ++i) {
+            if (!std::equal(
+                    lhs.v_chunks[i], lhs.v_chunks[i] + lhs.words_in_use(i),
+                    rhs.v_chunks[i]
+                )) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool
+    operator!=(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+    // Three-way lexicographical comparison, false < true, a word at a time:
+    // the lowest differing bit decides.
+    friend int
+    compare(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        const size_type min_size = std::min(lhs.v_size, rhs.v_size);
+        for (size_type pos = 0; pos < min_size; pos += bits_per_word) {
+            const size_type n = std::min(bits_per_word, min_size - pos);
+            const word_type diff = *lhs.word_of(pos) ^ *rhs.word_of(pos);
+            const word_type masked = diff & low_bits(n);
+            if (masked != 0) {
+                const word_type lowest = masked & (~masked + 1);
+                return (*lhs.word_of(pos) & lowest) != 0 ? 1 : -1;
+            }
+        }
+        if (lhs.v_size == rhs.v_size) {
+            return 0;
+        }
+        return lhs.v_size < rhs.v_size ? -1 : 1;
+    }
+
+    friend bool
+    operator<(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        return compare(lhs, rhs) < 0;
+    }
+
+    friend bool
+    operator>(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        return rhs < lhs;
+    }
+
+    friend bool
+    operator<=(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        return !(lhs > rhs);
+    }
+
+    friend bool
+    operator>=(const chunk_vector &lhs, const chunk_vector &rhs) noexcept {
+        return !(lhs < rhs);
+    }
+
+private:
+    // Sets or clears the bits of the last word in use past size().
+    void fill_bits_past_size(bool value) noexcept {
+        if (v_size % bits_per_word != 0) {
+            const size_type last = v_size - 1;
+            apply_mask(*word_of(last), ~word_type(0) << (v_size % 64), value);
+        }
+    }
+};
+}  // namespace CustomVector
+
+#endif  // CHUNK_VECTOR_BOOL_HPP
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Compare Google Benchmark outputs and flag regressions.
+
+Both arguments may be single result files (console ``.txt`` or ``.json``
+written by ``run-all-benchmarks``) or directories such as ``BM_results``;
+directories are matched by file name without the extension, a ``.json`` file
+taking precedence over a ``.txt`` file of the same name.  For JSON results
+with repetitions the median aggregate is compared.  A baseline can also be
+taken from git history with ``--git-ref``:
+
+    ./compare_results.py BM_results/benchmark_chunk_vector.txt new.txt
+    ./compare_results.py --git-ref HEAD~1 BM_results
+    ./compare_results.py BM_results/benchmark_stl_vector.txt \\
+        BM_results/benchmark_chunk_vector.txt --threshold 0.05
+
+The exit status is 1 when at least one benchmark got slower than the
+threshold allows, so the script can be used as a CI gate.
+"""
+
+import argparse
+import json
+import pathlib
+import re
+import subprocess
+import sys
+
+UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+CONSOLE_LINE = re.compile(
+    r"^(?P<name>.*\S)\s+"
+    r"(?P<time>\d+(?:\.\d+)?) (?P<time_unit>ns|us|ms|s)\s+"
+    r"(?P<cpu>\d+(?:\.\d+)?) (?P<cpu_unit>ns|us|ms|s)\s+"
+    r"(?P<iterations>\d+)"
+)
+
+
+def parse_console(text):
+    """Return {benchmark name: (real time ns, cpu time ns)}."""
+    results = {}
+    for line in text.splitlines():
+        match = CONSOLE_LINE.match(line)
+        if not match:
+            continue
+        results[match["name"]] = (
+            float(match["time"]) * UNITS[match["time_unit"]],
+            float(match["cpu"]) * UNITS[match["cpu_unit"]],
+        )
+    return results
+
+
+def parse_json(text):
+    """Return {benchmark name: (real time ns, cpu time ns)}.
+
+    Repeated runs are reduced to their median aggregate when it is present.
+    """
+    results = {}
+    medians = {}
+    for entry in json.loads(text)["benchmarks"]:
+        scale = UNITS[entry.get("time_unit", "ns")]
+        times = (entry["real_time"] * scale, entry["cpu_time"] * scale)
+        name = entry.get("run_name", entry["name"])
+        if entry.get("run_type") == "aggregate":
+            if entry.get("aggregate_name") == "median":
+                medians[name] = times
+        else:
+            results.setdefault(name, times)
+    results.update(medians)
+    return results
+
+
+def parse(path, text):
+    if path.suffix == ".json":
+        return parse_json(text)
+    return parse_console(text)
+
+
+def read_text(path, git_ref):
+    if git_ref is None:
+        return path.read_text()
+    return subprocess.run(
+        ["git", "show", f"{git_ref}:{path.as_posix()}"],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+
+
+def collect(path, git_ref=None):
+    """Return {file stem: parsed results} for a file or a directory."""
+    if git_ref is None and path.is_dir():
+        files = sorted(path.glob("*.txt")) + sorted(path.glob("*.json"))
+    elif git_ref is not None and not path.suffix:
+        listing = subprocess.run(
+            ["git", "ls-tree", "--name-only", f"{git_ref}:{path.as_posix()}"],
+            check=True,
+            capture_output=True,
+            text=True,
+        ).stdout.split()
+        files = [
+            path / name for name in listing if name.endswith((".txt", ".json"))
+        ]
+    else:
+        files = [path]
+    # JSON files come last, so they replace console output of the same stem.
+    files = sorted(files, key=lambda file: file.suffix == ".json")
+    chosen = {file.stem: file for file in files}
+    return {
+        stem: parse(file, read_text(file, git_ref))
+        for stem, file in sorted(chosen.items())
+    }
+
+
+def compare(base, new, threshold, use_cpu):
+    """Print a table of relative changes and return the number of regressions."""
+    column = 1 if use_cpu else 0
+    regressions = 0
+    names = [name for name in base if name in new]
+    if not names:
+        return 0
+    width = max(len(name) for name in names)
+    print(f"{'Benchmark':<{width}}  {'Base':>14}  {'New':>14}  {'Change':>8}")
+    for name in names:
+        old_time = base[name][column]
+        new_time = new[name][column]
+        change = (new_time - old_time) / old_time if old_time else 0.0
+        flag = ""
+        if change > threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif change < -threshold:
+            flag = "  improvement"
+        print(
+            f"{name:<{width}}  {old_time:>11.1f} ns  {new_time:>11.1f} ns  "
+            f"{change:>+7.1%}{flag}"
+        )
+    for name in sorted(set(base) - set(new)):
+        print(f"{name:<{width}}  missing in new results")
+    for name in sorted(set(new) - set(base)):
+        print(f"{name:<{width}}  new benchmark")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("base", type=pathlib.Path, help="baseline file or dir")
+    parser.add_argument(
+        "new",
+        type=pathlib.Path,
+        nargs="?",
+        help="new file or dir (defaults to BASE when --git-ref is given)",
+    )
+    parser.add_argument(
+        "--git-ref", help="read the baseline from this git revision instead"
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="relative slowdown reported as a regression (default: 0.1)",
+    )
+    parser.add_argument(
+        "--cpu", action="store_true", help="compare CPU time instead of wall time"
+    )
+    args = parser.parse_args()
+
+    new_path = args.new if args.new is not None else args.base
+    base = collect(args.base, args.git_ref)
+    new = collect(new_path)
+    if len(base) == 1 and len(new) == 1:
+        (title, base_results), (_, new_results) = *base.items(), *new.items()
+        pairs = [(title, base_results, new_results)]
+    else:
+        pairs = [(name, base[name], new[name]) for name in base if name in new]
+
+    regressions = 0
+    for title, base_results, new_results in pairs:
+        print(f"== {title}")
+        regressions += compare(base_results, new_results, args.threshold, args.cpu)
+        print()
+    if regressions:
+        print(f"{regressions} regression(s) above {args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,609 @@
+#ifndef COMPRESSED_CHUNK_VECTOR_HPP
+#define COMPRESSED_CHUNK_VECTOR_HPP
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+// Encoding of a sealed chunk of a compressed_chunk_vector.
+enum class chunk_codec : unsigned char {
+    // The elements as they are, when no codec makes them smaller.
+    raw,
+    // Differences of neighbours, zigzag-mapped and stored as varints.
+    delta_varint,
+    // The minimum and the offsets from it in as few bits as they need.
+    frame_of_reference,
+    // Pairs of a value and the length of its run, as varints.
+    run_length
+};
+
+namespace detail {
+// Codecs of compressed_chunk_vector. Values are handled as 64-bit words:
+// signed ones are sign-extended, so differences and offsets wrap around
+// correctly for every integral type up to 64 bits.
+template <typename T>
+std::uint64_t to_word(T value) noexcept {
+    if constexpr (std::is_signed_v<T>) {
+        return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+    } else {
+        return static_cast<std::uint64_t>(value);
+    }
+}
+
+template <typename T>
+T from_word(std::uint64_t word) noexcept {
+    return static_cast<T>(word);
+}
+
+inline std::uint64_t zigzag_encode(std::uint64_t word) noexcept {
+    return (word << 1) ^ (0 - (word >> 63));
+}
+
+inline std::uint64_t zigzag_decode(std::uint64_t word) noexcept {
+    return (word >> 1) ^ (0 - (word & 1));
+}
+
+template <class Bytes>
+void put_varint(std::uint64_t word, Bytes &out) {
+    while (word >= 0x80) {
+        out.push_back(static_cast<unsigned char>(word | 0x80));
+        word >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(word));
+}
+
+inline std::uint64_t get_varint(const unsigned char *&in) noexcept {
+    std::uint64_t word = 0;
+    for (int shift = 0;; shift += 7) {
+        const unsigned char byte = *in++;
+        word |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            return word;
+        }
+    }
+}
+
+template <class Bytes>
+void put_word(std::uint64_t word, Bytes &out) {
+    unsigned char bytes[sizeof(word)];
+    std::memcpy(bytes, &word, sizeof(word));
+    out.insert(out.end(), bytes, bytes + sizeof(word));
+}
+
+inline std::uint64_t get_word(const unsigned char *in) noexcept {
+    std::uint64_t word;
+    std::memcpy(&word, in, sizeof(word));
+    return word;
+}
+
+template <typename T, class Bytes>
+void encode_raw(const T *data, std::size_t n, Bytes &out) {
+    const auto *bytes = reinterpret_cast<const unsigned char *>(data);
+    out.insert(out.end(), bytes, bytes + n * sizeof(T));
+}
+
+template <typename T>
+void decode_raw(const unsigned char *in, std::size_t n, T *out) noexcept {
+    std::memcpy(out, in, n * sizeof(T));
+}
+
+template <typename T, class Bytes>
+void encode_delta_varint(const T *data, std::size_t n, Bytes &out) {
+    std::uint64_t previous = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t word = to_word(data[i]);
+        put_varint(zigzag_encode(word - previous), out);
+        previous = word;
+    }
+}
+
+template <typename T>
+void decode_delta_varint(const unsigned char *in, std::size_t n, T *out)
+    noexcept {
+    std::uint64_t previous = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        previous += zigzag_decode(get_varint(in));
+        out[i] = from_word<T>(previous);
+    }
+}
+
+// Layout: the minimum as a word, the bit width as a byte, then the offsets
+// packed into words, lowest bits first.
+template <typename T, class Bytes>
+void encode_frame_of_reference(const T *data, std::size_t n, Bytes &out) {
+    const auto [low, high] = std::minmax_element(data, data + n);
+    const std::uint64_t base = to_word(*low);
+    const std::uint64_t range = to_word(*high) - base;
+    unsigned width = 0;
+    while (width < 64 && (range >> width) != 0) {
+        ++width;
+    }
+    put_word(base, out);
+    out.push_back(static_cast<unsigned char>(width));
+    if (width == 0) {
+        return;
+    }
+    std::uint64_t word = 0;
+    unsigned used = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t offset = to_word(data[i]) - base;
+        word |= offset << used;
+        used += width;
+        if (used >= 64) {
+            put_word(word, out);
+            used -= 64;
+            word = used == 0 ? 0 : offset >> (width - used);
+        }
+    }
+    if (used != 0) {
+        put_word(word, out);
+    }
+}
+
+template <typename T>
+void decode_frame_of_reference(const unsigned char *in, std::size_t n, T *out)
+    noexcept {
+    const std::uint64_t base = get_word(in);
+    const unsigned width = in[sizeof(base)];
+    const unsigned char *words = in + sizeof(base) + 1;
+    if (width == 0) {
+        std::fill(out, out + n, from_word<T>(base));
+        return;
+    }
+    const std::uint64_t mask =
+        width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+    std::uint64_t word = get_word(words);
+    unsigned used = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t offset = word >> used;
+        used += width;
+        if (used >= 64) {
+            used -= 64;
+            words += sizeof(word);
+            // The last value may end exactly at the last word.
+            if (used != 0 || i + 1 < n) {
+                word = get_word(words);
+            }
+            if (used != 0) {
+                offset |= word << (width - used);
+            }
+        }
+        out[i] = from_word<T>(base + (offset & mask));
+    }
+}
+
+template <typename T, class Bytes>
+void encode_run_length(const T *data, std::size_t n, Bytes &out) {
+    for (std::size_t i = 0; i < n;) {
+        std::size_t run = 1;
+        while (i + run < n && data[i + run] == data[i]) {
+            ++run;
+        }
+        put_varint(zigzag_encode(to_word(data[i])), out);
+        put_varint(run, out);
+        i += run;
+    }
+}
+
+template <typename T>
+void decode_run_length(const unsigned char *in, std::size_t n, T *out)
+    noexcept {
+    for (std::size_t i = 0; i < n;) {
+        const T value = from_word<T>(zigzag_decode(get_varint(in)));
+        const std::size_t run = get_varint(in);
+        std::fill(out + i, out + i + run, value);
+        i += run;
+    }
+}
+}  // namespace detail
+
+// Vector of integers that keeps its full chunks compressed once they are
+// sealed; only the chunks after them, the hot tail, are kept in a
+// chunk_vector as they are. Each sealed chunk is stored with the smallest
+// of the chunk_codec encodings, so slowly changing timelines, values in a
+// narrow range and long runs take a fraction of their size.
+//
+// Chunks are sealed by seal() or, after set_auto_seal(hot_chunks), as soon
+// as the tail has more than hot_chunks full chunks. Reading a sealed
+// element decodes its chunk into a small cache of decoded chunks; scans
+// should use for_each_chunk, which decodes each chunk once. Elements are
+// returned by value, and set() re-encodes a sealed chunk. Even const
+// access updates the cache, so a vector must not be read from several
+// threads at once.
+template <
+    typename T,
+    std::size_t chunk_size = (sizeof(T) > 8192 ? 1 : 8192 / sizeof(T)),
+    typename Alloc = std::allocator<T>>
+class compressed_chunk_vector {
+    static_assert(
+        std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) <= 8,
+        "compressed_chunk_vector holds integers of up to 64 bits"
+    );
+
+public:
+    // Member types
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_reference = T;
+
+    static constexpr size_type no_auto_seal =
+        std::numeric_limits<size_type>::max();
+
+private:
+    using bytes = std::vector<
+        unsigned char,
+        typename std::allocator_traits<Alloc>::template rebind_alloc<
+            unsigned char>>;
+
+    using encoder_type = void (*)(const T *, std::size_t, bytes &);
+
+    struct sealed_chunk {
+        chunk_codec codec;
+        bytes data;
+    };
+
+    struct cache_slot {
+        size_type chunk = no_chunk;
+        std::uint64_t last_use = 0;
+        std::vector<T, Alloc> values;
+    };
+
+    static constexpr size_type no_chunk = std::numeric_limits<size_type>::max();
+    static constexpr size_type cache_slots = 4;
+
+    class value_iterator {
+    private:
+        const compressed_chunk_vector *m_owner;
+        size_type m_index;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        value_iterator() noexcept : m_owner(nullptr), m_index(0) {
+        }
+
+        value_iterator(const compressed_chunk_vector *owner, size_type index)
+            noexcept
+            : m_owner(owner), m_index(index) {
+        }
+
+        T operator*() const {
+            return (*m_owner)[m_index];
+        }
+
+        value_iterator &operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+
+        value_iterator operator++(int) noexcept {
+            value_iterator copy = *this;
+            ++m_index;
+            return copy;
+        }
+
+        bool operator==(const value_iterator &other) const noexcept {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const value_iterator &other) const noexcept {
+            return m_index != other.m_index;
+        }
+    };
+
+    std::vector<sealed_chunk> v_sealed;
+    chunk_vector<T, chunk_size, Alloc> v_tail;
+    size_type v_hot_chunks = no_auto_seal;
+    mutable std::array<cache_slot, cache_slots> v_cache;
+    mutable std::uint64_t v_clock = 0;
+
+    [[nodiscard]] size_type sealed_size() const noexcept {
+        return v_sealed.size() * chunk_size;
+    }
+
+    void check_out_of_bound(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range(
+                "Requested index: " + std::to_string(index) +
+                ", size: " + std::to_string(size())
+            );
+        }
+    }
+
+    // Encodes chunk_size elements with every codec and keeps the smallest.
+    sealed_chunk encode(const T *data) const {
+        const auto alloc = typename bytes::allocator_type(get_allocator());
+        sealed_chunk best{chunk_codec::raw, bytes(alloc)};
+        detail::encode_raw(data, chunk_size, best.data);
+        const auto try_codec = [&](chunk_codec codec, encoder_type encoder) {
+            bytes candidate(alloc);
+            encoder(data, chunk_size, candidate);
+            if (candidate.size() < best.data.size()) {
+                best.codec = codec;
+                best.data.swap(candidate);
+            }
+        };
+        try_codec(
+            chunk_codec::delta_varint, detail::encode_delta_varint<T, bytes>
+        );
+        try_codec(
+            chunk_codec::frame_of_reference,
+            detail::encode_frame_of_reference<T, bytes>
+        );
+        try_codec(chunk_codec::run_length, detail::encode_run_length<T, bytes>);
+        best.data.shrink_to_fit();
+        return best;
+    }
+
+    static void decode(const sealed_chunk &chunk, T *out) noexcept {
+        const unsigned char *in = chunk.data.data();
+        switch (chunk.codec) {
+            case chunk_codec::raw:
+                detail::decode_raw(in, chunk_size, out);
+                break;
+            case chunk_codec::delta_varint:
+                detail::decode_delta_varint(in, chunk_size, out);
+                break;
+            case chunk_codec::frame_of_reference:
+                detail::decode_frame_of_reference(in, chunk_size, out);
+                break;
+            case chunk_codec::run_length:
+                detail::decode_run_length(in, chunk_size, out);
+                break;
+        }
+    }
+
+    // The decoded elements of sealed chunk, from the cache if they are
+    // there; otherwise they replace the least recently used entry.
+    const T *decoded_chunk(size_type chunk) const {
+        cache_slot *victim = &v_cache[0];
+        for (cache_slot &slot : v_cache) {
+            if (slot.chunk == chunk) {
+                slot.last_use = ++v_clock;
+                return slot.values.data();
+            }
+            if (slot.last_use < victim->last_use) {
+                victim = &slot;
+            }
+        }
+        victim->values.resize(chunk_size);
+        decode(v_sealed[chunk], victim->values.data());
+        victim->chunk = chunk;
+        victim->last_use = ++v_clock;
+        return victim->values.data();
+    }
+
+    void forget_cached(size_type chunk) const noexcept {
+        for (cache_slot &slot : v_cache) {
+            if (slot.chunk == chunk) {
+                slot.chunk = no_chunk;
+                slot.last_use = 0;
+            }
+        }
+    }
+
+    // Compresses the first count chunks of the tail.
+    void seal_front(size_type count) {
+        if (count == 0) {
+            return;
+        }
+        std::vector<sealed_chunk> sealed;
+        sealed.reserve(count);
+        for (size_type i = 0; i < count; ++i) {
+            sealed.push_back(encode(v_tail.chunk_data(i)));
+        }
+        v_sealed.reserve(v_sealed.size() + count);
+        auto rest = v_tail.split_at(count * chunk_size);
+        v_tail.swap(rest);
+        std::move(sealed.begin(), sealed.end(), std::back_inserter(v_sealed));
+    }
+
+    void auto_seal() {
+        const size_type full_chunks = v_tail.size() / chunk_size;
+        if (v_hot_chunks != no_auto_seal && full_chunks > v_hot_chunks) {
+            seal_front(full_chunks - v_hot_chunks);
+        }
+    }
+
+public:
+    using iterator = value_iterator;
+    using const_iterator = value_iterator;
+
+    compressed_chunk_vector() = default;
+
+    explicit compressed_chunk_vector(const allocator_type &alloc)
+        : v_tail(alloc) {
+    }
+
+    compressed_chunk_vector(
+        std::initializer_list<value_type> init,
+        const allocator_type &alloc = allocator_type()
+    )
+        : v_tail(init, alloc) {
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return v_tail.get_allocator();
+    }
+
+    // Element access
+    T operator[](size_type pos) const {
+        if (pos >= sealed_size()) {
+            return v_tail[pos - sealed_size()];
+        }
+        return decoded_chunk(pos / chunk_size)[pos % chunk_size];
+    }
+
+    [[nodiscard]] T at(size_type pos) const {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    [[nodiscard]] T front() const {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] T back() const {
+        return (*this)[size() - 1];
+    }
+
+    // Replaces the element at pos; a sealed chunk is decoded and encoded
+    // again.
+    void set(size_type pos, T value) {
+        if (pos >= sealed_size()) {
+            v_tail[pos - sealed_size()] = value;
+            return;
+        }
+        const size_type chunk = pos / chunk_size;
+        std::vector<T, Alloc> values(chunk_size, get_allocator());
+        decode(v_sealed[chunk], values.data());
+        values[pos % chunk_size] = value;
+        v_sealed[chunk] = encode(values.data());
+        forget_cached(chunk);
+    }
+
+    // Calls f(data, n) for every chunk in order, sealed ones decoded into a
+    // buffer that is reused for the next chunk.
+    template <class F>
+    void for_each_chunk(F f) const {
+        if (!v_sealed.empty()) {
+            std::vector<T, Alloc> values(chunk_size, get_allocator());
+            for (const sealed_chunk &chunk : v_sealed) {
+                decode(chunk, values.data());
+                f(static_cast<const T *>(values.data()), chunk_size);
+            }
+        }
+        v_tail.for_each_chunk(0, v_tail.chunk_count(), f);
+    }
+
+    // Iterators
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(this, size());
+    }
+
+    // Capacity
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return sealed_size() + v_tail.size();
+    }
+
+    [[nodiscard]] size_type sealed_chunk_count() const noexcept {
+        return v_sealed.size();
+    }
+
+    [[nodiscard]] chunk_codec sealed_chunk_codec(size_type chunk
+    ) const noexcept {
+        return v_sealed[chunk].codec;
+    }
+
+    // Bytes of heap held for the elements: compressed chunks, the tail and
+    // the decoded chunk cache.
+    [[nodiscard]] size_type memory_usage() const noexcept {
+        size_type result = v_sealed.capacity() * sizeof(sealed_chunk) +
+                           v_tail.capacity() * sizeof(T);
+        for (const sealed_chunk &chunk : v_sealed) {
+            result += chunk.data.capacity();
+        }
+        for (const cache_slot &slot : v_cache) {
+            result += slot.values.capacity() * sizeof(T);
+        }
+        return result;
+    }
+
+    void shrink_to_fit() {
+        v_tail.shrink_to_fit();
+        v_sealed.shrink_to_fit();
+        for (cache_slot &slot : v_cache) {
+            slot = cache_slot();
+        }
+    }
+
+    // Sealing
+    // Compresses every full chunk of the tail.
+    void seal() {
+        seal_front(v_tail.size() / chunk_size);
+    }
+
+    // Keeps at most hot_chunks full chunks uncompressed from now on, sealing
+    // older ones as the vector grows; no_auto_seal turns this off.
+    void set_auto_seal(size_type hot_chunks) {
+        v_hot_chunks = hot_chunks;
+        auto_seal();
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        v_sealed.clear();
+        v_tail.clear();
+        for (cache_slot &slot : v_cache) {
+            slot.chunk = no_chunk;
+            slot.last_use = 0;
+        }
+    }
+
+    void push_back(T value) {
+        v_tail.push_back(value);
+        if (v_tail.size() % chunk_size == 0) {
+            auto_seal();
+        }
+    }
+
+    // Unseals the last sealed chunk when the tail is empty.
+    void pop_back() {
+        if (v_tail.empty()) {
+            const sealed_chunk &last = v_sealed.back();
+            v_tail.append_uninitialized(
+                chunk_size,
+                [&last](T *data, size_type) { decode(last, data); }
+            );
+            forget_cached(v_sealed.size() - 1);
+            v_sealed.pop_back();
+        }
+        v_tail.pop_back();
+    }
+
+    void swap(compressed_chunk_vector &other) noexcept {
+        v_sealed.swap(other.v_sealed);
+        v_tail.swap(other.v_tail);
+        std::swap(v_hot_chunks, other.v_hot_chunks);
+        std::swap(v_cache, other.v_cache);
+        std::swap(v_clock, other.v_clock);
+    }
+};
+
+template <typename T, std::size_t chunk_size, typename Alloc>
+void swap(
+    compressed_chunk_vector<T, chunk_size, Alloc> &lhs,
+    compressed_chunk_vector<T, chunk_size, Alloc> &rhs
+) noexcept {
+    lhs.swap(rhs);
+}
+}  // namespace CustomVector
+
+#endif  // COMPRESSED_CHUNK_VECTOR_HPP
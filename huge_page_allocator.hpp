@@ -0,0 +1,194 @@
+#ifndef HUGE_PAGE_ALLOCATOR_HPP
+#define HUGE_PAGE_ALLOCATOR_HPP
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace CustomVector {
+inline constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+// Process-wide pool of 2 MiB regions backed by transparent huge pages.
+// Blocks of one byte size are carved out of a region back to back and never
+// cross its end, so a chunk always lives inside a single huge page. Freed
+// blocks go to a per-size free list and are reused; regions are kept for the
+// lifetime of the process. Blocks larger than half a huge page get their own
+// huge-page-aligned mapping and are returned to the system on deallocation.
+class huge_page_pool {
+private:
+    struct free_block {
+        free_block *next;
+    };
+
+    struct size_class {
+        free_block *free_list = nullptr;
+        std::byte *region_pos = nullptr;
+        std::byte *region_end = nullptr;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::size_t, size_class> classes;
+
+    huge_page_pool() = default;
+
+    static std::size_t round_up(std::size_t bytes, std::size_t alignment) {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    static void *map_huge(std::size_t bytes) {
+#ifdef __linux__
+        // Over-allocate by one huge page to be able to align the mapping,
+        // then give the unaligned head and tail back.
+        const std::size_t mapped = bytes + huge_page_size;
+        void *raw = mmap(
+            nullptr, mapped, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+        );
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        auto address = reinterpret_cast<std::uintptr_t>(raw);
+        const std::uintptr_t aligned = round_up(address, huge_page_size);
+        if (aligned != address) {
+            munmap(raw, aligned - address);
+        }
+        const std::size_t tail = mapped - (aligned - address) - bytes;
+        if (tail != 0) {
+            munmap(reinterpret_cast<void *>(aligned + bytes), tail);
+        }
+        // Only a hint: without THP support the pages stay regular ones.
+        madvise(reinterpret_cast<void *>(aligned), bytes, MADV_HUGEPAGE);
+        return reinterpret_cast<void *>(aligned);
+#else
+        return ::operator new(bytes, std::align_val_t(huge_page_size));
+#endif
+    }
+
+    static void unmap_huge(void *p, std::size_t bytes) noexcept {
+#ifdef __linux__
+        munmap(p, bytes);
+#else
+        (void)bytes;
+        ::operator delete(p, std::align_val_t(huge_page_size));
+#endif
+    }
+
+public:
+    huge_page_pool(const huge_page_pool &) = delete;
+
+    huge_page_pool &operator=(const huge_page_pool &) = delete;
+
+    // The pool is never destroyed: a vector with static storage duration
+    // that allocates after the first call would otherwise return its chunks
+    // to a destroyed pool at exit. The regions are never unmapped anyway.
+    static huge_page_pool &instance() {
+        static huge_page_pool *pool = new huge_page_pool;
+        return *pool;
+    }
+
+    // Largest request whose block, rounded up to whole huge pages and
+    // over-mapped by one more, still fits in std::size_t.
+    static constexpr std::size_t max_bytes =
+        std::numeric_limits<std::size_t>::max() - 2 * huge_page_size;
+
+    static std::size_t block_size(std::size_t bytes) noexcept {
+        return round_up(
+            bytes < sizeof(free_block) ? sizeof(free_block) : bytes,
+            alignof(std::max_align_t)
+        );
+    }
+
+    void *allocate(std::size_t bytes) {
+        if (bytes > max_bytes) {
+            throw std::bad_alloc();
+        }
+        const std::size_t size = block_size(bytes);
+        if (size > huge_page_size / 2) {
+            return map_huge(round_up(size, huge_page_size));
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        size_class &cls = classes[size];
+        if (cls.free_list != nullptr) {
+            free_block *block = cls.free_list;
+            cls.free_list = block->next;
+            return block;
+        }
+        if (static_cast<std::size_t>(cls.region_end - cls.region_pos) < size) {
+            cls.region_pos = static_cast<std::byte *>(map_huge(huge_page_size));
+            cls.region_end = cls.region_pos + huge_page_size;
+        }
+        void *block = cls.region_pos;
+        cls.region_pos += size;
+        return block;
+    }
+
+    void deallocate(void *p, std::size_t bytes) noexcept {
+        const std::size_t size = block_size(bytes);
+        if (size > huge_page_size / 2) {
+            unmap_huge(p, round_up(size, huge_page_size));
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        size_class &cls = classes[size];
+        cls.free_list = new (p) free_block{cls.free_list};
+    }
+};
+
+// Stateless allocator for chunk_vector that places chunks in huge pages:
+//
+//     chunk_vector<int, 2048, huge_page_allocator<int>> v;
+//
+// Any chunk size works; with chunk bytes dividing 2 MiB (the default 8 KiB
+// chunks do for power-of-two element sizes) regions are used without waste.
+template <typename T>
+struct huge_page_allocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    huge_page_allocator() noexcept = default;
+
+    template <typename U>
+    huge_page_allocator(const huge_page_allocator<U> &) noexcept {
+    }
+
+    [[nodiscard]] static constexpr std::size_t max_size() noexcept {
+        return huge_page_pool::max_bytes / sizeof(T);
+    }
+
+    T *allocate(std::size_t n) {
+        static_assert(
+            alignof(T) <= alignof(std::max_align_t),
+            "over-aligned types are not supported"
+        );
+        if (n > max_size()) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T *>(
+            huge_page_pool::instance().allocate(n * sizeof(T))
+        );
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        huge_page_pool::instance().deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const huge_page_allocator<U> &) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const huge_page_allocator<U> &) const noexcept {
+        return false;
+    }
+};
+}  // namespace CustomVector
+
+#endif  // HUGE_PAGE_ALLOCATOR_HPP
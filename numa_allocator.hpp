@@ -0,0 +1,378 @@
+#ifndef NUMA_ALLOCATOR_HPP
+#define NUMA_ALLOCATOR_HPP
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace CustomVector {
+namespace detail {
+// Node ids of a sysfs node list such as "0-3,5".
+inline std::vector<int> parse_node_list(const std::string &list) {
+    std::vector<int> nodes;
+    std::istringstream ranges(list);
+    std::string range;
+    while (std::getline(ranges, range, ',')) {
+        const std::size_t dash = range.find('-');
+        const int first = std::stoi(range.substr(0, dash));
+        int last = first;
+        if (dash != std::string::npos) {
+            last = std::stoi(range.substr(dash + 1));
+        }
+        for (int node = first; node <= last; ++node) {
+            nodes.push_back(node);
+        }
+    }
+    return nodes;
+}
+}  // namespace detail
+
+// Ids of the NUMA nodes the system has online in increasing order, {0} when
+// they can not be detected. The ids need not be dense: nodes can be offline.
+inline std::vector<int> numa_online_nodes() {
+#ifdef __linux__
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if (online >> list) {
+        std::vector<int> nodes = detail::parse_node_list(list);
+        if (!nodes.empty()) {
+            return nodes;
+        }
+    }
+#endif
+    return {0};
+}
+
+// Number of NUMA nodes the system has online, 1 when it can not be detected.
+inline std::size_t numa_node_count() {
+    return numa_online_nodes().size();
+}
+
+// Node of the CPU the calling thread runs on, 0 when it is unknown.
+inline int current_numa_node() noexcept {
+#ifdef __linux__
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+// Node that holds the page at p, or -1 if the page is not populated yet or the
+// kernel does not report it. move_pages without target nodes only reports
+// where the page is, so an untouched page stays unpopulated; get_mempolicy
+// with MPOL_F_ADDR would fault it in on the calling thread's node.
+inline int numa_node_of(const void *p) noexcept {
+#ifdef __linux__
+    void *pages[] = {const_cast<void *>(p)};
+    int status = -1;
+    if (syscall(SYS_move_pages, 0, 1, pages, nullptr, &status, 0) == 0 &&
+        status >= 0) {
+        return status;
+    }
+#else
+    (void)p;
+#endif
+    return -1;
+}
+
+enum class numa_policy {
+    // Leave placement to the kernel: pages land on the node of the thread
+    // that writes them first.
+    first_touch,
+    // Chunk i goes to nodes[i % nodes.size()].
+    interleave,
+    // Chunks [k * chunks_per_node, (k + 1) * chunks_per_node) go to
+    // nodes[k % nodes.size()].
+    blocked,
+};
+
+// Placement shared by all copies of a numa_allocator. Chunks are numbered in
+// allocation order, which for a vector filled by push_back is the chunk index.
+class numa_placement {
+private:
+    numa_policy policy;
+    std::vector<int> nodes;
+    std::size_t chunks_per_node;
+    std::atomic<std::size_t> next_chunk{0};
+
+public:
+    numa_placement(
+        numa_policy policy,
+        std::vector<int> nodes,
+        std::size_t chunks_per_node = 1
+    )
+        : policy(policy),
+          nodes(std::move(nodes)),
+          chunks_per_node(chunks_per_node == 0 ? 1 : chunks_per_node) {
+    }
+
+    explicit numa_placement(numa_policy policy, std::size_t chunks_per_node = 1)
+        : numa_placement(policy, all_nodes(), chunks_per_node) {
+    }
+
+    static std::vector<int> all_nodes() {
+        return numa_online_nodes();
+    }
+
+    // Node for the next chunk, or -1 to keep the default policy.
+    int next_node() noexcept {
+        if (policy == numa_policy::first_touch || nodes.size() < 2) {
+            return -1;
+        }
+        const std::size_t chunk = next_chunk.fetch_add(1);
+        if (policy == numa_policy::interleave) {
+            return nodes[chunk % nodes.size()];
+        }
+        return nodes[chunk / chunks_per_node % nodes.size()];
+    }
+};
+
+#ifdef __linux__
+inline constexpr std::size_t numa_arena_size = std::size_t(64) << 20;
+
+// Process-wide arenas for numa_allocator. Blocks of one byte size and node
+// are carved out of a numa_arena_size region back to back, so a region costs
+// one mmap and one mbind however many chunks it holds, and chunks interleaved
+// over the nodes do not need a mapping each (vm.max_map_count, 65530 by
+// default, would cap a vector of 8 KiB chunks at about 512 MiB). Freed blocks
+// go to a free list of their node and size and are reused with the pages they
+// already have; regions are kept for the lifetime of the process. Blocks
+// larger than half a region get their own mapping and are returned to the
+// system on deallocation.
+class numa_arena_pool {
+private:
+    struct free_block {
+        free_block *next;
+    };
+
+    struct size_class {
+        free_block *free_list = nullptr;
+        std::byte *region_pos = nullptr;
+        std::byte *region_end = nullptr;
+    };
+
+    std::mutex mutex;
+    // Keyed by node and block size; node -1 leaves placement to first touch.
+    std::map<std::pair<int, std::size_t>, size_class> classes;
+    // Node of the region starting at each address.
+    std::map<std::uintptr_t, int> region_nodes;
+
+    numa_arena_pool() = default;
+
+    static void *map_region(std::size_t bytes, int node) {
+        void *p = mmap(
+            nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+            -1, 0
+        );
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        if (node >= 0 && node < 64) {
+            // Preferred rather than bound: a full node falls back to others
+            // instead of failing. Errors (no NUMA support) are ignored.
+            const unsigned long mask = 1UL << node;
+            syscall(
+                SYS_mbind, p, bytes, MPOL_PREFERRED, &mask, sizeof(mask) * 8, 0
+            );
+        }
+        return p;
+    }
+
+public:
+    numa_arena_pool(const numa_arena_pool &) = delete;
+
+    numa_arena_pool &operator=(const numa_arena_pool &) = delete;
+
+    // Never destroyed, like huge_page_pool, so that vectors with static
+    // storage duration can release their chunks at exit.
+    static numa_arena_pool &instance() {
+        static numa_arena_pool *pool = new numa_arena_pool;
+        return *pool;
+    }
+
+    // bytes is a multiple of the page size, so blocks never share a page.
+    void *allocate(std::size_t bytes, int node) {
+        if (bytes > numa_arena_size / 2) {
+            return map_region(bytes, node);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        size_class &cls = classes[{node, bytes}];
+        if (cls.free_list != nullptr) {
+            free_block *block = cls.free_list;
+            cls.free_list = block->next;
+            return block;
+        }
+        if (static_cast<std::size_t>(cls.region_end - cls.region_pos) < bytes) {
+            void *region = map_region(numa_arena_size, node);
+            try {
+                region_nodes.emplace(
+                    reinterpret_cast<std::uintptr_t>(region), node
+                );
+            } catch (...) {
+                munmap(region, numa_arena_size);
+                throw;
+            }
+            cls.region_pos = static_cast<std::byte *>(region);
+            cls.region_end = cls.region_pos + numa_arena_size;
+        }
+        void *block = cls.region_pos;
+        cls.region_pos += bytes;
+        return block;
+    }
+
+    void deallocate(void *p, std::size_t bytes) noexcept {
+        if (bytes > numa_arena_size / 2) {
+            munmap(p, bytes);
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto address = reinterpret_cast<std::uintptr_t>(p);
+        const int node = std::prev(region_nodes.upper_bound(address))->second;
+        // The size class exists since the block was carved out for it.
+        size_class &cls = classes.find({node, bytes})->second;
+        cls.free_list = new (p) free_block{cls.free_list};
+    }
+};
+#endif
+
+// Allocator that takes every chunk from the arena of a node chosen by a
+// numa_placement (see numa_arena_pool). On single-node machines and outside
+// Linux it behaves like a plain page allocator. Chunks are rounded up to whole
+// pages, so chunk sizes that are a multiple of the page size waste nothing:
+//
+//     numa_allocator<int> alloc(numa_policy::interleave);
+//     chunk_vector<int, 4096, numa_allocator<int>> v(alloc);
+template <typename T>
+class numa_allocator {
+private:
+    template <typename>
+    friend class numa_allocator;
+
+    std::shared_ptr<numa_placement> placement;
+
+    static std::size_t mapped_size(std::size_t n) noexcept {
+#ifdef __linux__
+        static const auto page =
+            static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+        constexpr std::size_t page = 4096;
+#endif
+        return (n * sizeof(T) + page - 1) / page * page;
+    }
+
+public:
+    using value_type = T;
+
+    numa_allocator()
+        : placement(std::make_shared<numa_placement>(numa_policy::first_touch)
+          ) {
+    }
+
+    explicit numa_allocator(numa_policy policy, std::size_t chunks_per_node = 1)
+        : placement(std::make_shared<numa_placement>(policy, chunks_per_node)) {
+    }
+
+    explicit numa_allocator(std::shared_ptr<numa_placement> placement) noexcept
+        : placement(std::move(placement)) {
+    }
+
+    // Copies share the placement; there is no move constructor so that a
+    // moved-from allocator stays usable.
+    numa_allocator(const numa_allocator &other) noexcept = default;
+
+    numa_allocator &operator=(const numa_allocator &other) noexcept = default;
+
+    template <typename U>
+    numa_allocator(const numa_allocator<U> &other) noexcept
+        : placement(other.placement) {
+    }
+
+    T *allocate(std::size_t n) {
+        const std::size_t bytes = mapped_size(n);
+#ifdef __linux__
+        const int node = placement->next_node();
+        void *p = numa_arena_pool::instance().allocate(bytes, node);
+        return static_cast<T *>(p);
+#else
+        placement->next_node();
+        return static_cast<T *>(::operator new(bytes));
+#endif
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+#ifdef __linux__
+        numa_arena_pool::instance().deallocate(p, mapped_size(n));
+#else
+        (void)n;
+        ::operator delete(p);
+#endif
+    }
+
+    // Memory of any numa_allocator can be released by any other one.
+    template <typename U>
+    bool operator==(const numa_allocator<U> &) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const numa_allocator<U> &) const noexcept {
+        return false;
+    }
+};
+
+// Groups the chunks of a chunk_vector by the node their memory is on, so that
+// workers running on node n can scan result[n] and read only local memory;
+// the groups of offline node ids stay empty.
+// Chunks whose node is unknown, usually because nothing has touched them yet,
+// are not faulted in: they are dealt out to the nodes in contiguous slabs, so
+// that with first_touch the worker of each node places its slab locally.
+template <class Vector>
+std::vector<std::vector<std::size_t>> chunks_by_numa_node(const Vector &v) {
+    const std::vector<int> online = numa_online_nodes();
+    std::vector<std::vector<std::size_t>> result(online.back() + 1);
+    std::vector<std::size_t> unknown;
+    for (std::size_t chunk = 0; chunk < v.chunk_count(); ++chunk) {
+        const int node = numa_node_of(v.chunk_data(chunk));
+        if (node < 0) {
+            unknown.push_back(chunk);
+            continue;
+        }
+        const auto index = static_cast<std::size_t>(node);
+        if (index >= result.size()) {
+            result.resize(index + 1);
+        }
+        result[index].push_back(chunk);
+    }
+    for (std::size_t i = 0; i < unknown.size(); ++i) {
+        auto &node_chunks = result[online[i * online.size() / unknown.size()]];
+        node_chunks.push_back(unknown[i]);
+    }
+    for (auto &node_chunks : result) {
+        std::sort(node_chunks.begin(), node_chunks.end());
+    }
+    return result;
+}
+}  // namespace CustomVector
+
+#endif  // NUMA_ALLOCATOR_HPP
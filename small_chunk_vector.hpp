@@ -0,0 +1,543 @@
+#ifndef SMALL_CHUNK_VECTOR_HPP
+#define SMALL_CHUNK_VECTOR_HPP
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+namespace detail {
+// Allocator of a small_chunk_vector. It is not an alloc_wrapper, because an
+// empty alloc_wrapper base would collide with the one of the chunk_vector in
+// the union and get padded.
+template <
+    typename T,
+    typename Alloc,
+    bool = std::allocator_traits<Alloc>::is_always_equal::value>
+struct small_alloc_holder {
+    Alloc alloc;
+
+    small_alloc_holder() = default;
+
+    small_alloc_holder(const Alloc &alloc) : alloc(alloc) {
+    }
+
+    template <typename... Args>
+    void construct(T *p, Args &&...args) {
+        std::allocator_traits<Alloc>::construct(
+            alloc, p, std::forward<Args>(args)...
+        );
+    }
+
+    Alloc get_alloc_copy() const {
+        return alloc;
+    }
+};
+
+template <typename T, typename Alloc>
+struct small_alloc_holder<T, Alloc, true> {
+    small_alloc_holder() = default;
+
+    small_alloc_holder(const Alloc &) {
+    }
+
+    template <typename... Args>
+    void construct(T *p, Args &&...args) {
+        Alloc alloc;
+        std::allocator_traits<Alloc>::construct(
+            alloc, p, std::forward<Args>(args)...
+        );
+    }
+
+    Alloc get_alloc_copy() const {
+        return Alloc();
+    }
+};
+}  // namespace detail
+
+// chunk_vector with the first inline_capacity elements stored in the object
+// itself. Until it outgrows the buffer a small_chunk_vector allocates
+// nothing; then its elements move to a chunk_vector that shares the storage
+// of the buffer, and it stays chunked until shrink_to_fit() brings it back.
+//
+//     small_chunk_vector<int, 16> v;  // 72 bytes, no heap for 16 ints
+template <
+    typename T,
+    std::size_t inline_capacity,
+    std::size_t chunk_size = (sizeof(T) > 8192 ? 1 : 8192 / sizeof(T)),
+    typename Alloc = std::allocator<T>>
+class small_chunk_vector : private detail::small_alloc_holder<T, Alloc> {
+    static_assert(inline_capacity > 0, "use chunk_vector instead");
+
+private:
+    template <bool is_const>
+    class small_iterator {
+    private:
+        using Owner = std::conditional_t<
+            is_const,
+            const small_chunk_vector,
+            small_chunk_vector>;
+        Owner *m_owner;
+        std::size_t m_index;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<is_const, const T *, T *>;
+        using reference = std::conditional_t<is_const, const T &, T &>;
+
+        small_iterator() noexcept : m_owner(nullptr), m_index(0) {
+        }
+
+        small_iterator(Owner *owner, std::size_t index) noexcept
+            : m_owner(owner), m_index(index) {
+        }
+
+        operator small_iterator<true>() const noexcept {
+            return small_iterator<true>(m_owner, m_index);
+        }
+
+        reference operator*() const noexcept {
+            return (*m_owner)[m_index];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*m_owner)[m_index];
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return (*m_owner)[m_index + n];
+        }
+
+        small_iterator &operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+
+        small_iterator operator++(int) noexcept {
+            small_iterator copy = *this;
+            ++m_index;
+            return copy;
+        }
+
+        small_iterator &operator--() noexcept {
+            --m_index;
+            return *this;
+        }
+
+        small_iterator operator--(int) noexcept {
+            small_iterator copy = *this;
+            --m_index;
+            return copy;
+        }
+
+        small_iterator &operator+=(difference_type n) noexcept {
+            m_index += n;
+            return *this;
+        }
+
+        small_iterator &operator-=(difference_type n) noexcept {
+            m_index -= n;
+            return *this;
+        }
+
+        small_iterator operator+(difference_type n) const noexcept {
+            return small_iterator(m_owner, m_index + n);
+        }
+
+        small_iterator operator-(difference_type n) const noexcept {
+            return small_iterator(m_owner, m_index - n);
+        }
+
+        difference_type operator-(const small_iterator &other) const noexcept {
+            return static_cast<difference_type>(m_index) -
+                   static_cast<difference_type>(other.m_index);
+        }
+
+        bool operator==(const small_iterator &other) const noexcept {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const small_iterator &other) const noexcept {
+            return m_index != other.m_index;
+        }
+
+        bool operator<(const small_iterator &other) const noexcept {
+            return m_index < other.m_index;
+        }
+
+        bool operator>(const small_iterator &other) const noexcept {
+            return m_index > other.m_index;
+        }
+
+        bool operator<=(const small_iterator &other) const noexcept {
+            return m_index <= other.m_index;
+        }
+
+        bool operator>=(const small_iterator &other) const noexcept {
+            return m_index >= other.m_index;
+        }
+    };
+
+public:
+    // Member types
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using chunks_type = chunk_vector<T, chunk_size, Alloc>;
+    using iterator = small_iterator<false>;
+    using const_iterator = small_iterator<true>;
+
+private:
+    // s_size is the number of inline elements, or chunked when the elements
+    // live in s_chunks.
+    static constexpr size_type chunked = std::numeric_limits<size_type>::max();
+
+    union {
+        alignas(T) unsigned char s_buffer[inline_capacity * sizeof(T)];
+        chunks_type s_chunks;
+    };
+    size_type s_size;
+
+    T *inline_data() noexcept {
+        return reinterpret_cast<T *>(s_buffer);
+    }
+
+    const T *inline_data() const noexcept {
+        return reinterpret_cast<const T *>(s_buffer);
+    }
+
+    // Leaves the vector inline and empty.
+    void destroy() noexcept {
+        if (is_inline()) {
+            std::destroy_n(inline_data(), s_size);
+        } else {
+            s_chunks.~chunks_type();
+        }
+        s_size = 0;
+    }
+
+    // Takes the elements of other, which is left inline and empty; *this
+    // must be inline and empty.
+    void take(small_chunk_vector &other) noexcept(
+        std::is_nothrow_move_constructible_v<T>
+    ) {
+        if (other.is_inline()) {
+            std::uninitialized_move_n(
+                other.inline_data(), other.s_size, inline_data()
+            );
+            s_size = other.s_size;
+        } else {
+            new (&s_chunks) chunks_type(std::move(other.s_chunks));
+            s_size = chunked;
+        }
+        other.destroy();
+    }
+
+    // Moves the inline elements into chunks able to hold new_capacity.
+    void move_to_chunks(size_type new_capacity) {
+        chunks_type chunks(this->get_alloc_copy());
+        chunks.reserve(new_capacity);
+        T *data = inline_data();
+        for (size_type i = 0; i < s_size; ++i) {
+            chunks.push_back(std::move(data[i]));
+        }
+        std::destroy_n(data, s_size);
+        new (&s_chunks) chunks_type(std::move(chunks));
+        s_size = chunked;
+    }
+
+    void check_out_of_bound(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range(
+                "Requested index: " + std::to_string(index) +
+                ", size: " + std::to_string(size())
+            );
+        }
+    }
+
+public:
+    // Constructors
+    small_chunk_vector() noexcept : s_size(0) {
+    }
+
+    explicit small_chunk_vector(const allocator_type &alloc) noexcept
+        : detail::small_alloc_holder<T, Alloc>(alloc), s_size(0) {
+    }
+
+    small_chunk_vector(
+        std::initializer_list<value_type> init,
+        const allocator_type &alloc = allocator_type()
+    )
+        : detail::small_alloc_holder<T, Alloc>(alloc), s_size(0) {
+        reserve(init.size());
+        for (const_reference value : init) {
+            push_back(value);
+        }
+    }
+
+    small_chunk_vector(const small_chunk_vector &other)
+        : detail::small_alloc_holder<T, Alloc>(
+              std::allocator_traits<allocator_type>::
+                  select_on_container_copy_construction(other.get_allocator())
+          ),
+          s_size(0) {
+        reserve(other.size());
+        for (const_reference value : other) {
+            push_back(value);
+        }
+    }
+
+    small_chunk_vector(small_chunk_vector &&other) noexcept(
+        std::is_nothrow_move_constructible_v<T>
+    )
+        : detail::small_alloc_holder<T, Alloc>(other.get_alloc_copy()),
+          s_size(0) {
+        take(other);
+    }
+
+    small_chunk_vector &operator=(const small_chunk_vector &other) {
+        if (this != &other) {
+            small_chunk_vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    small_chunk_vector &operator=(small_chunk_vector &&other) noexcept(
+        std::is_nothrow_move_constructible_v<T>
+    ) {
+        if (this != &other) {
+            destroy();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~small_chunk_vector() {
+        destroy();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->get_alloc_copy();
+    }
+
+    // Element access
+    reference at(size_type pos) & {
+        check_out_of_bound(pos);
+        return operator[](pos);
+    }
+
+    [[nodiscard]] const_reference at(size_type pos) const & {
+        check_out_of_bound(pos);
+        return operator[](pos);
+    }
+
+    reference operator[](size_type pos) & noexcept {
+        return is_inline() ? inline_data()[pos] : s_chunks[pos];
+    }
+
+    const_reference operator[](size_type pos) const & noexcept {
+        return is_inline() ? inline_data()[pos] : s_chunks[pos];
+    }
+
+    reference front() & noexcept {
+        return operator[](0);
+    }
+
+    [[nodiscard]] const_reference front() const & noexcept {
+        return operator[](0);
+    }
+
+    reference back() & noexcept {
+        return operator[](size() - 1);
+    }
+
+    [[nodiscard]] const_reference back() const & noexcept {
+        return operator[](size() - 1);
+    }
+
+    // Iterators
+    iterator begin() noexcept {
+        return iterator(this, 0);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    iterator end() noexcept {
+        return iterator(this, size());
+    }
+
+    const_iterator end() const noexcept {
+        return const_iterator(this, size());
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Capacity
+    [[nodiscard]] bool is_inline() const noexcept {
+        return s_size != chunked;
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return is_inline() ? s_size : s_chunks.size();
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return is_inline() ? inline_capacity : s_chunks.capacity();
+    }
+
+    void reserve(size_type k) & {
+        if (!is_inline()) {
+            s_chunks.reserve(k);
+        } else if (k > inline_capacity) {
+            move_to_chunks(k);
+        }
+    }
+
+    // Frees unused chunks, and returns to the inline buffer if the elements
+    // fit into it.
+    void shrink_to_fit() & {
+        if (is_inline()) {
+            return;
+        }
+        if (s_chunks.size() > inline_capacity) {
+            s_chunks.shrink_to_fit();
+            return;
+        }
+        chunks_type chunks(std::move(s_chunks));
+        s_chunks.~chunks_type();
+        try {
+            std::uninitialized_move_n(
+                chunks.begin(), chunks.size(), inline_data()
+            );
+        } catch (...) {
+            new (&s_chunks) chunks_type(std::move(chunks));
+            throw;
+        }
+        s_size = chunks.size();
+    }
+
+    // Modifiers
+    void clear() & noexcept {
+        if (is_inline()) {
+            std::destroy_n(inline_data(), s_size);
+            s_size = 0;
+        } else {
+            s_chunks.clear();
+        }
+    }
+
+    void push_back(const_reference value) & {
+        emplace_back(value);
+    }
+
+    void push_back(value_type &&value) & {
+        emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args) & {
+        if (s_size < inline_capacity) {
+            T *pos_for_new_value = inline_data() + s_size;
+            this->construct(pos_for_new_value, std::forward<Args>(args)...);
+            ++s_size;
+            return *pos_for_new_value;
+        }
+        if (is_inline()) {
+            // args may refer to an inline element, which moving to chunks
+            // leaves moved from and destroys, so the new element is made
+            // first.
+            value_type value(std::forward<Args>(args)...);
+            move_to_chunks(inline_capacity + 1);
+            return s_chunks.emplace_back(std::move(value));
+        }
+        return s_chunks.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void pop_back() & noexcept {
+        if (is_inline()) {
+            inline_data()[--s_size].~value_type();
+        } else {
+            s_chunks.pop_back();
+        }
+    }
+
+    void resize(size_type count) & {
+        while (size() > count) {
+            pop_back();
+        }
+        reserve(count);
+        while (size() < count) {
+            emplace_back();
+        }
+    }
+
+    void resize(size_type count, const_reference value) & {
+        while (size() > count) {
+            pop_back();
+        }
+        if (is_inline() && count > inline_capacity) {
+            // value may be an inline element, which reserve moves away.
+            const value_type copy(value);
+            reserve(count);
+            resize(count, copy);
+            return;
+        }
+        reserve(count);
+        while (size() < count) {
+            push_back(value);
+        }
+    }
+
+    void swap(small_chunk_vector &other) noexcept(
+        std::is_nothrow_move_constructible_v<T>
+    ) {
+        small_chunk_vector tmp(std::move(other));
+        other.take(*this);
+        take(tmp);
+    }
+
+    // Friend functions
+    friend bool operator==(
+        const small_chunk_vector &lhs,
+        const small_chunk_vector &rhs
+    ) noexcept {
+        return lhs.size() == rhs.size() &&
+               std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(
+        const small_chunk_vector &lhs,
+        const small_chunk_vector &rhs
+    ) noexcept {
+        return !(lhs == rhs);
+    }
+};
+}  // namespace CustomVector
+
+#endif  // SMALL_CHUNK_VECTOR_HPP
@@ -0,0 +1,711 @@
+#ifndef SORTED_CHUNK_VECTOR_HPP
+#define SORTED_CHUNK_VECTOR_HPP
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+// Vector kept sorted by Compare, with duplicates, whose chunks work like the
+// leaves of a B+-tree: a chunk holds from one to chunk_size elements, and
+// the first element of every chunk, its fence, is kept in a contiguous
+// array. lower_bound and the other lookups binary-search the fences and
+// then a single chunk, instead of probing chunks all over memory.
+//
+// insert() places an element after the equal ones, shifting the rest of
+// its chunk only; a full chunk is split in halves first, except when
+// sorted input is appended at the end, where a new chunk is started and
+// the full ones stay full. A chunk emptied by erase() is released.
+// Elements are read-only, since writing them could break the order, and
+// operator[] finds the chunk of an index by binary search too.
+//
+//     sorted_chunk_vector<int> v{5, 1, 3};
+//     v.insert(2);                          // 1 2 3 5
+//     bool found = v.contains(3);
+//     auto it = v.lower_bound(4);           // *it == 5
+template <
+    typename T,
+    std::size_t chunk_size = (sizeof(T) > 4096 ? 2 : 8192 / sizeof(T)),
+    typename Compare = std::less<T>,
+    typename Alloc = std::allocator<T>>
+class sorted_chunk_vector : private alloc_wrapper<T, Alloc, void> {
+    static_assert(chunk_size >= 2, "full chunks are split in halves");
+
+public:
+    // Member types
+    using value_type = T;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const T &;
+    using const_reference = const T &;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer =
+        typename std::allocator_traits<Alloc>::const_pointer;
+
+private:
+    struct leaf {
+        pointer data;
+        size_type length;
+        // Index of the first element.
+        size_type start;
+    };
+
+    // Points to chunk m_chunk at m_offset < its length, or is end() with
+    // m_chunk == chunk_count() and m_offset == 0.
+    class value_iterator {
+    private:
+        friend class sorted_chunk_vector;
+
+        const sorted_chunk_vector *m_owner;
+        size_type m_chunk;
+        size_type m_offset;
+
+        [[nodiscard]] size_type index() const noexcept {
+            return m_owner->leaf_start(m_chunk) + m_offset;
+        }
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        value_iterator() noexcept
+            : m_owner(nullptr), m_chunk(0), m_offset(0) {
+        }
+
+        value_iterator(
+            const sorted_chunk_vector *owner,
+            size_type chunk,
+            size_type offset
+        ) noexcept
+            : m_owner(owner), m_chunk(chunk), m_offset(offset) {
+        }
+
+        reference operator*() const noexcept {
+            return m_owner->v_leaves[m_chunk].data[m_offset];
+        }
+
+        pointer operator->() const noexcept {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return *(*this + n);
+        }
+
+        value_iterator &operator++() noexcept {
+            if (++m_offset == m_owner->v_leaves[m_chunk].length) {
+                ++m_chunk;
+                m_offset = 0;
+            }
+            return *this;
+        }
+
+        value_iterator operator++(int) noexcept {
+            value_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        value_iterator &operator--() noexcept {
+            if (m_offset == 0) {
+                --m_chunk;
+                m_offset = m_owner->v_leaves[m_chunk].length;
+            }
+            --m_offset;
+            return *this;
+        }
+
+        value_iterator operator--(int) noexcept {
+            value_iterator copy = *this;
+            --*this;
+            return copy;
+        }
+
+        value_iterator &operator+=(difference_type n) noexcept {
+            return *this = m_owner->iterator_at(index() + n);
+        }
+
+        value_iterator &operator-=(difference_type n) noexcept {
+            return *this += -n;
+        }
+
+        value_iterator operator+(difference_type n) const noexcept {
+            value_iterator copy = *this;
+            return copy += n;
+        }
+
+        friend value_iterator
+        operator+(difference_type n, const value_iterator &it) noexcept {
+            return it + n;
+        }
+
+        value_iterator operator-(difference_type n) const noexcept {
+            value_iterator copy = *this;
+            return copy -= n;
+        }
+
+        difference_type operator-(const value_iterator &other
+        ) const noexcept {
+            return static_cast<difference_type>(index()) -
+                   static_cast<difference_type>(other.index());
+        }
+
+        bool operator==(const value_iterator &other) const noexcept {
+            return m_chunk == other.m_chunk && m_offset == other.m_offset;
+        }
+
+        bool operator!=(const value_iterator &other) const noexcept {
+            return !(*this == other);
+        }
+
+        bool operator<(const value_iterator &other) const noexcept {
+            return index() < other.index();
+        }
+
+        bool operator>(const value_iterator &other) const noexcept {
+            return other < *this;
+        }
+
+        bool operator<=(const value_iterator &other) const noexcept {
+            return !(other < *this);
+        }
+
+        bool operator>=(const value_iterator &other) const noexcept {
+            return !(*this < other);
+        }
+    };
+
+    std::vector<leaf> v_leaves;
+    // The first element of every chunk.
+    std::vector<T, Alloc> v_fences;
+    size_type v_size = 0;
+    Compare v_compare;
+
+    [[nodiscard]] size_type leaf_start(size_type chunk) const noexcept {
+        return chunk < v_leaves.size() ? v_leaves[chunk].start : v_size;
+    }
+
+    [[nodiscard]] value_iterator iterator_at(size_type index) const noexcept {
+        if (index >= v_size) {
+            return end();
+        }
+        const auto next = std::upper_bound(
+            v_leaves.begin(), v_leaves.end(), index,
+            [](size_type i, const leaf &l) { return i < l.start; }
+        );
+        const size_type chunk = next - v_leaves.begin() - 1;
+        return value_iterator(this, chunk, index - v_leaves[chunk].start);
+    }
+
+    void check_out_of_bound(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range(
+                "Requested index: " + std::to_string(index) +
+                ", size: " + std::to_string(size())
+            );
+        }
+    }
+
+    void shift_starts(size_type first_chunk, difference_type delta) noexcept {
+        for (size_type i = first_chunk; i < v_leaves.size(); ++i) {
+            v_leaves[i].start += delta;
+        }
+    }
+
+    // Adds an empty chunk at position chunk with the given fence.
+    void insert_leaf(size_type chunk, const T &fence) {
+        v_leaves.reserve(v_leaves.size() + 1);
+        v_fences.insert(v_fences.begin() + chunk, fence);
+        pointer data;
+        try {
+            data = this->allocate(chunk_size);
+        } catch (...) {
+            v_fences.erase(v_fences.begin() + chunk);
+            throw;
+        }
+        v_leaves.insert(
+            v_leaves.begin() + chunk, leaf{data, 0, leaf_start(chunk)}
+        );
+    }
+
+    void erase_leaf(size_type chunk) noexcept {
+        this->deallocate(v_leaves[chunk].data, chunk_size);
+        v_leaves.erase(v_leaves.begin() + chunk);
+        v_fences.erase(v_fences.begin() + chunk);
+    }
+
+    // Moves the upper half of a full chunk into a new chunk after it.
+    void split(size_type chunk) {
+        constexpr size_type half = chunk_size / 2;
+        insert_leaf(chunk + 1, v_leaves[chunk].data[half]);
+        leaf &lower = v_leaves[chunk];
+        leaf &upper = v_leaves[chunk + 1];
+        try {
+            std::uninitialized_move(
+                lower.data + half, lower.data + chunk_size, upper.data
+            );
+        } catch (...) {
+            erase_leaf(chunk + 1);
+            throw;
+        }
+        std::destroy(lower.data + half, lower.data + chunk_size);
+        lower.length = half;
+        upper.length = chunk_size - half;
+        upper.start = lower.start + half;
+    }
+
+    // Inserts value at offset of chunk, which has room for it.
+    value_iterator
+    insert_into(size_type chunk, size_type offset, T &&value) {
+        leaf &target = v_leaves[chunk];
+        const pointer data = target.data;
+        if (offset == target.length) {
+            this->construct(data + offset, std::move(value));
+        } else {
+            this->construct(
+                data + target.length, std::move(data[target.length - 1])
+            );
+        }
+        ++target.length;
+        ++v_size;
+        shift_starts(chunk + 1, 1);
+        if (offset + 1 != target.length) {
+            std::move_backward(
+                data + offset, data + target.length - 2,
+                data + target.length - 1
+            );
+            data[offset] = std::move(value);
+        }
+        if (offset == 0) {
+            v_fences[chunk] = data[0];
+        }
+        return value_iterator(this, chunk, offset);
+    }
+
+    // Appends value, which is not less than the last element.
+    template <class U>
+    void append(U &&value) {
+        if (v_leaves.empty() || v_leaves.back().length == chunk_size) {
+            insert_leaf(v_leaves.size(), value);
+        }
+        leaf &last = v_leaves.back();
+        try {
+            this->construct(last.data + last.length, std::forward<U>(value));
+        } catch (...) {
+            if (last.length == 0) {
+                erase_leaf(v_leaves.size() - 1);
+            }
+            throw;
+        }
+        ++last.length;
+        ++v_size;
+    }
+
+public:
+    using const_iterator = value_iterator;
+    using iterator = value_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reverse_iterator = const_reverse_iterator;
+
+    sorted_chunk_vector() = default;
+
+    explicit sorted_chunk_vector(
+        const Compare &comp,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc_wrapper<T, Alloc, void>(alloc),
+          v_fences(alloc),
+          v_compare(comp) {
+    }
+
+    explicit sorted_chunk_vector(const allocator_type &alloc)
+        : sorted_chunk_vector(Compare(), alloc) {
+    }
+
+    // Sorts a copy of the range and fills the chunks completely.
+    template <
+        class InputIt,
+        std::enable_if_t<
+            std::is_base_of_v<
+                std::input_iterator_tag,
+                typename std::iterator_traits<InputIt>::iterator_category>,
+            bool> = true>
+    sorted_chunk_vector(
+        InputIt first,
+        InputIt last,
+        const Compare &comp = Compare(),
+        const allocator_type &alloc = allocator_type()
+    )
+        : sorted_chunk_vector(comp, alloc) {
+        std::vector<T, Alloc> values(first, last, alloc);
+        std::stable_sort(values.begin(), values.end(), v_compare);
+        try {
+            for (T &value : values) {
+                append(std::move(value));
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    sorted_chunk_vector(
+        std::initializer_list<value_type> init,
+        const Compare &comp = Compare(),
+        const allocator_type &alloc = allocator_type()
+    )
+        : sorted_chunk_vector(init.begin(), init.end(), comp, alloc) {
+    }
+
+    // The copy has full chunks.
+    sorted_chunk_vector(const sorted_chunk_vector &other)
+        : sorted_chunk_vector(
+              other.v_compare,
+              std::allocator_traits<allocator_type>::
+                  select_on_container_copy_construction(other.get_allocator())
+          ) {
+        try {
+            for (const T &value : other) {
+                append(value);
+            }
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    sorted_chunk_vector(sorted_chunk_vector &&other) noexcept
+        : alloc_wrapper<T, Alloc, void>(std::move(other.get_alloc_ref())),
+          v_leaves(std::move(other.v_leaves)),
+          v_fences(std::move(other.v_fences)),
+          v_size(std::exchange(other.v_size, 0)),
+          v_compare(other.v_compare) {
+        other.v_leaves.clear();
+        other.v_fences.clear();
+    }
+
+    sorted_chunk_vector &operator=(const sorted_chunk_vector &other) {
+        if (this != &other) {
+            sorted_chunk_vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    sorted_chunk_vector &operator=(sorted_chunk_vector &&other) noexcept {
+        if (this != &other) {
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~sorted_chunk_vector() {
+        clear();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->get_alloc_copy();
+    }
+
+    key_compare key_comp() const {
+        return v_compare;
+    }
+
+    // Element access
+    const_reference operator[](size_type pos) const noexcept {
+        return *iterator_at(pos);
+    }
+
+    [[nodiscard]] const_reference at(size_type pos) const {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    [[nodiscard]] const_reference front() const noexcept {
+        return v_leaves.front().data[0];
+    }
+
+    [[nodiscard]] const_reference back() const noexcept {
+        const leaf &last = v_leaves.back();
+        return last.data[last.length - 1];
+    }
+
+    // Lookup
+    // The first element not less than key.
+    [[nodiscard]] const_iterator lower_bound(const T &key) const {
+        const size_type next =
+            std::lower_bound(
+                v_fences.begin(), v_fences.end(), key, v_compare
+            ) -
+            v_fences.begin();
+        if (next != 0) {
+            const leaf &candidate = v_leaves[next - 1];
+            const size_type offset =
+                std::lower_bound(
+                    candidate.data, candidate.data + candidate.length, key,
+                    v_compare
+                ) -
+                candidate.data;
+            if (offset != candidate.length) {
+                return const_iterator(this, next - 1, offset);
+            }
+        }
+        return const_iterator(this, next, 0);
+    }
+
+    // The first element greater than key.
+    [[nodiscard]] const_iterator upper_bound(const T &key) const {
+        const size_type next =
+            std::upper_bound(
+                v_fences.begin(), v_fences.end(), key, v_compare
+            ) -
+            v_fences.begin();
+        if (next != 0) {
+            const leaf &candidate = v_leaves[next - 1];
+            const size_type offset =
+                std::upper_bound(
+                    candidate.data, candidate.data + candidate.length, key,
+                    v_compare
+                ) -
+                candidate.data;
+            if (offset != candidate.length) {
+                return const_iterator(this, next - 1, offset);
+            }
+        }
+        return const_iterator(this, next, 0);
+    }
+
+    [[nodiscard]] std::pair<const_iterator, const_iterator>
+    equal_range(const T &key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    [[nodiscard]] const_iterator find(const T &key) const {
+        const const_iterator it = lower_bound(key);
+        return it != end() && !v_compare(key, *it) ? it : end();
+    }
+
+    [[nodiscard]] bool contains(const T &key) const {
+        return find(key) != end();
+    }
+
+    [[nodiscard]] size_type count(const T &key) const {
+        return upper_bound(key) - lower_bound(key);
+    }
+
+    // Chunk access
+    [[nodiscard]] size_type chunk_count() const noexcept {
+        return v_leaves.size();
+    }
+
+    [[nodiscard]] const T *chunk_data(size_type chunk) const noexcept {
+        return v_leaves[chunk].data;
+    }
+
+    [[nodiscard]] size_type chunk_length(size_type chunk) const noexcept {
+        return v_leaves[chunk].length;
+    }
+
+    // The first element of chunk.
+    [[nodiscard]] const T &fence(size_type chunk) const noexcept {
+        return v_fences[chunk];
+    }
+
+    // Calls f(data, n) for every chunk in order.
+    template <class F>
+    void for_each_chunk(F f) const {
+        for (const leaf &l : v_leaves) {
+            f(static_cast<const T *>(l.data), l.length);
+        }
+    }
+
+    // Iterators
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(this, 0, 0);
+    }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(this, v_leaves.size(), 0);
+    }
+
+    [[nodiscard]] const_iterator cend() const noexcept {
+        return end();
+    }
+
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+
+    [[nodiscard]] const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    // Capacity
+    [[nodiscard]] bool empty() const noexcept {
+        return v_size == 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return v_size;
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return v_leaves.size() * chunk_size;
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        for (const leaf &l : v_leaves) {
+            std::destroy_n(l.data, l.length);
+            this->deallocate(l.data, chunk_size);
+        }
+        v_leaves.clear();
+        v_fences.clear();
+        v_size = 0;
+    }
+
+    // Inserts after the elements equal to the new one.
+    template <class... Args>
+    const_iterator emplace(Args &&...args) {
+        T value(std::forward<Args>(args)...);
+        if (v_leaves.empty() || !v_compare(value, back())) {
+            append(std::move(value));
+            return std::prev(end());
+        }
+        const size_type next =
+            std::upper_bound(
+                v_fences.begin(), v_fences.end(), value, v_compare
+            ) -
+            v_fences.begin();
+        size_type chunk = next == 0 ? 0 : next - 1;
+        size_type offset =
+            std::upper_bound(
+                v_leaves[chunk].data,
+                v_leaves[chunk].data + v_leaves[chunk].length, value, v_compare
+            ) -
+            v_leaves[chunk].data;
+        if (v_leaves[chunk].length == chunk_size) {
+            split(chunk);
+            if (offset > v_leaves[chunk].length) {
+                offset -= v_leaves[chunk].length;
+                ++chunk;
+            }
+        }
+        return insert_into(chunk, offset, std::move(value));
+    }
+
+    const_iterator insert(const T &value) {
+        return emplace(value);
+    }
+
+    const_iterator insert(T &&value) {
+        return emplace(std::move(value));
+    }
+
+    template <class InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            emplace(*first);
+        }
+    }
+
+    const_iterator erase(const_iterator pos) {
+        const size_type chunk = pos.m_chunk;
+        const size_type offset = pos.m_offset;
+        leaf &target = v_leaves[chunk];
+        std::move(
+            target.data + offset + 1, target.data + target.length,
+            target.data + offset
+        );
+        --target.length;
+        std::destroy_at(target.data + target.length);
+        --v_size;
+        shift_starts(chunk + 1, -1);
+        if (target.length == 0) {
+            erase_leaf(chunk);
+            return const_iterator(this, chunk, 0);
+        }
+        if (offset == 0) {
+            v_fences[chunk] = target.data[0];
+        }
+        if (offset == target.length) {
+            return const_iterator(this, chunk + 1, 0);
+        }
+        return pos;
+    }
+
+    const_iterator erase(const_iterator first, const_iterator last) {
+        const size_type index = first.index();
+        for (difference_type n = last - first; n > 0; --n) {
+            first = erase(first);
+        }
+        return iterator_at(index);
+    }
+
+    // Removes the elements equal to key and returns their number.
+    size_type erase(const T &key) {
+        const auto [first, last] = equal_range(key);
+        const size_type count = last - first;
+        erase(first, last);
+        return count;
+    }
+
+    void pop_back() {
+        erase(std::prev(end()));
+    }
+
+    void swap(sorted_chunk_vector &other) noexcept {
+        v_leaves.swap(other.v_leaves);
+        v_fences.swap(other.v_fences);
+        std::swap(v_size, other.v_size);
+        std::swap(v_compare, other.v_compare);
+    }
+
+    friend bool operator==(
+        const sorted_chunk_vector &lhs,
+        const sorted_chunk_vector &rhs
+    ) {
+        return lhs.size() == rhs.size() &&
+               std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(
+        const sorted_chunk_vector &lhs,
+        const sorted_chunk_vector &rhs
+    ) {
+        return !(lhs == rhs);
+    }
+};
+
+template <
+    typename T,
+    std::size_t chunk_size,
+    typename Compare,
+    typename Alloc>
+void swap(
+    sorted_chunk_vector<T, chunk_size, Compare, Alloc> &lhs,
+    sorted_chunk_vector<T, chunk_size, Compare, Alloc> &rhs
+) noexcept {
+    lhs.swap(rhs);
+}
+}  // namespace CustomVector
+
+#endif  // SORTED_CHUNK_VECTOR_HPP
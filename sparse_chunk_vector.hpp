@@ -0,0 +1,430 @@
+#ifndef SPARSE_CHUNK_VECTOR_HPP
+#define SPARSE_CHUNK_VECTOR_HPP
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+// Vector whose elements start out value-initialized and whose chunks are
+// allocated only when something is written to them. A chunk that was never
+// written has a null entry in the chunk table and reads as a shared
+// read-only chunk of default values, so resize() to a billion elements
+// costs one table entry per chunk and the memory follows the chunks
+// actually touched.
+//
+// Reads go through operator[] and the other const accessors; writes go
+// through write(pos) or write_chunk(chunk), which allocate the chunk on
+// first use.
+//
+//     sparse_chunk_vector<double> v(1'000'000'000);  // about 7.8 MB
+//     v.write(123'456'789) = 1.5;                     // one 8 KB chunk more
+template <
+    typename T,
+    std::size_t chunk_size = (sizeof(T) > 8192 ? 1 : 8192 / sizeof(T)),
+    typename Alloc = std::allocator<T>>
+class sparse_chunk_vector : private alloc_wrapper<T, Alloc, void> {
+public:
+    // Member types
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = typename std::allocator_traits<Alloc>::pointer;
+    using const_pointer =
+        typename std::allocator_traits<Alloc>::const_pointer;
+
+private:
+    class value_iterator {
+    private:
+        const sparse_chunk_vector *m_owner;
+        size_type m_index;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        value_iterator() noexcept : m_owner(nullptr), m_index(0) {
+        }
+
+        value_iterator(const sparse_chunk_vector *owner, size_type index)
+            noexcept
+            : m_owner(owner), m_index(index) {
+        }
+
+        reference operator*() const noexcept {
+            return (*m_owner)[m_index];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*m_owner)[m_index];
+        }
+
+        value_iterator &operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+
+        value_iterator operator++(int) noexcept {
+            value_iterator copy = *this;
+            ++m_index;
+            return copy;
+        }
+
+        bool operator==(const value_iterator &other) const noexcept {
+            return m_index == other.m_index;
+        }
+
+        bool operator!=(const value_iterator &other) const noexcept {
+            return m_index != other.m_index;
+        }
+    };
+
+    // Null for chunks that were never written.
+    std::vector<pointer> v_chunks;
+    size_type v_size = 0;
+
+    // chunk_size value-initialized elements, shared by all vectors of this
+    // type and never written.
+    static const T *default_chunk() {
+        static const std::unique_ptr<T[]> chunk(new T[chunk_size]());
+        return chunk.get();
+    }
+
+    void check_out_of_bound(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range(
+                "Requested index: " + std::to_string(index) +
+                ", size: " + std::to_string(size())
+            );
+        }
+    }
+
+    // Allocates chunk with the default values of its elements.
+    pointer materialize(size_type chunk) {
+        pointer data = this->allocate(chunk_size);
+        try {
+            std::uninitialized_value_construct_n(data, chunk_length(chunk));
+        } catch (...) {
+            this->deallocate(data, chunk_size);
+            throw;
+        }
+        v_chunks[chunk] = data;
+        return data;
+    }
+
+    void release_chunk(size_type chunk) noexcept {
+        if (v_chunks[chunk] != nullptr) {
+            std::destroy_n(v_chunks[chunk], chunk_length(chunk));
+            this->deallocate(v_chunks[chunk], chunk_size);
+            v_chunks[chunk] = nullptr;
+        }
+    }
+
+    void copy_chunks(const sparse_chunk_vector &other) {
+        v_chunks.assign(other.v_chunks.size(), nullptr);
+        v_size = other.v_size;
+        for (size_type i = 0; i < other.v_chunks.size(); ++i) {
+            if (other.v_chunks[i] != nullptr) {
+                pointer data = this->allocate(chunk_size);
+                try {
+                    std::uninitialized_copy_n(
+                        other.v_chunks[i], other.chunk_length(i), data
+                    );
+                } catch (...) {
+                    this->deallocate(data, chunk_size);
+                    throw;
+                }
+                v_chunks[i] = data;
+            }
+        }
+    }
+
+public:
+    using const_iterator = value_iterator;
+    using iterator = value_iterator;
+
+    sparse_chunk_vector() = default;
+
+    explicit sparse_chunk_vector(const allocator_type &alloc)
+        : alloc_wrapper<T, Alloc, void>(alloc) {
+    }
+
+    // count value-initialized elements, none of them allocated.
+    explicit sparse_chunk_vector(
+        size_type count,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc_wrapper<T, Alloc, void>(alloc) {
+        resize(count);
+    }
+
+    // Copies the allocated chunks only.
+    sparse_chunk_vector(const sparse_chunk_vector &other)
+        : alloc_wrapper<T, Alloc, void>(
+              std::allocator_traits<allocator_type>::
+                  select_on_container_copy_construction(other.get_allocator())
+          ) {
+        try {
+            copy_chunks(other);
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    sparse_chunk_vector(sparse_chunk_vector &&other) noexcept
+        : alloc_wrapper<T, Alloc, void>(std::move(other.get_alloc_ref())),
+          v_chunks(std::move(other.v_chunks)),
+          v_size(std::exchange(other.v_size, 0)) {
+        other.v_chunks.clear();
+    }
+
+    sparse_chunk_vector &operator=(const sparse_chunk_vector &other) {
+        if (this != &other) {
+            sparse_chunk_vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    sparse_chunk_vector &operator=(sparse_chunk_vector &&other) noexcept {
+        if (this != &other) {
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~sparse_chunk_vector() {
+        clear();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->get_alloc_copy();
+    }
+
+    // Element access
+    const_reference operator[](size_type pos) const noexcept {
+        const T *data = v_chunks[pos / chunk_size];
+        if (data == nullptr) {
+            data = default_chunk();
+        }
+        return data[pos % chunk_size];
+    }
+
+    [[nodiscard]] const_reference at(size_type pos) const {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    [[nodiscard]] const_reference front() const noexcept {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] const_reference back() const noexcept {
+        return (*this)[v_size - 1];
+    }
+
+    // Write access
+    // The element at pos, allocating its chunk if it was never written.
+    reference write(size_type pos) {
+        return write_chunk(pos / chunk_size)[pos % chunk_size];
+    }
+
+    // The elements of chunk, allocating it if it was never written.
+    pointer write_chunk(size_type chunk) {
+        const pointer data = v_chunks[chunk];
+        return data != nullptr ? data : materialize(chunk);
+    }
+
+    // Chunk access
+    [[nodiscard]] size_type chunk_count() const noexcept {
+        return v_chunks.size();
+    }
+
+    [[nodiscard]] size_type chunk_length(size_type chunk) const noexcept {
+        return std::min(chunk_size, v_size - chunk * chunk_size);
+    }
+
+    [[nodiscard]] bool is_materialized(size_type chunk) const noexcept {
+        return v_chunks[chunk] != nullptr;
+    }
+
+    [[nodiscard]] size_type materialized_chunk_count() const noexcept {
+        return static_cast<size_type>(std::count_if(
+            v_chunks.begin(), v_chunks.end(),
+            [](pointer data) { return data != nullptr; }
+        ));
+    }
+
+    // Calls f(data, n) for every chunk in order; chunks that were never
+    // written pass the shared chunk of default values.
+    template <class F>
+    void for_each_chunk(F f) const {
+        for (size_type i = 0; i < v_chunks.size(); ++i) {
+            const T *data =
+                v_chunks[i] != nullptr ? v_chunks[i] : default_chunk();
+            f(data, chunk_length(i));
+        }
+    }
+
+    // Calls f(chunk, data, n) for the allocated chunks only.
+    template <class F>
+    void for_each_materialized_chunk(F f) {
+        for (size_type i = 0; i < v_chunks.size(); ++i) {
+            if (v_chunks[i] != nullptr) {
+                f(i, v_chunks[i], chunk_length(i));
+            }
+        }
+    }
+
+    template <class F>
+    void for_each_materialized_chunk(F f) const {
+        for (size_type i = 0; i < v_chunks.size(); ++i) {
+            if (v_chunks[i] != nullptr) {
+                f(i, static_cast<const T *>(v_chunks[i]), chunk_length(i));
+            }
+        }
+    }
+
+    // Iterators
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return const_iterator(this, 0);
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return const_iterator(this, v_size);
+    }
+
+    // Capacity
+    [[nodiscard]] bool empty() const noexcept {
+        return v_size == 0;
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return v_size;
+    }
+
+    // Bytes of heap held: the chunk table and the allocated chunks.
+    [[nodiscard]] size_type memory_usage() const noexcept {
+        return v_chunks.capacity() * sizeof(pointer) +
+               materialized_chunk_count() * chunk_size * sizeof(T);
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        for (size_type i = 0; i < v_chunks.size(); ++i) {
+            release_chunk(i);
+        }
+        v_chunks.clear();
+        v_size = 0;
+    }
+
+    // New elements are value-initialized; only an allocated last chunk has
+    // them constructed.
+    void resize(size_type count) {
+        const size_type chunks = (count + chunk_size - 1) / chunk_size;
+        if (count < v_size) {
+            for (size_type i = v_chunks.size(); i > chunks; --i) {
+                release_chunk(i - 1);
+            }
+            v_chunks.resize(chunks);
+            const size_type last = count % chunk_size;
+            if (last != 0 && v_chunks.back() != nullptr) {
+                std::destroy(
+                    v_chunks.back() + last,
+                    v_chunks.back() + chunk_length(chunks - 1)
+                );
+            }
+            v_size = count;
+            return;
+        }
+        // Set up the default chunk here, so that reads can not throw.
+        default_chunk();
+        const size_type old_chunks = v_chunks.size();
+        v_chunks.resize(chunks, nullptr);
+        const size_type last = v_size % chunk_size;
+        if (last != 0 && v_chunks[old_chunks - 1] != nullptr) {
+            try {
+                std::uninitialized_value_construct_n(
+                    v_chunks[old_chunks - 1] + last,
+                    std::min(chunk_size, count - v_size + last) - last
+                );
+            } catch (...) {
+                v_chunks.resize(old_chunks);
+                throw;
+            }
+        }
+        v_size = count;
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args) {
+        const size_type chunk = v_size / chunk_size;
+        const bool new_chunk = chunk == v_chunks.size();
+        if (new_chunk) {
+            v_chunks.push_back(nullptr);
+        }
+        try {
+            const pointer data = write_chunk(chunk);
+            this->construct(
+                data + v_size % chunk_size, std::forward<Args>(args)...
+            );
+            ++v_size;
+            return data[(v_size - 1) % chunk_size];
+        } catch (...) {
+            if (new_chunk) {
+                release_chunk(chunk);
+                v_chunks.pop_back();
+            }
+            throw;
+        }
+    }
+
+    void push_back(const T &value) {
+        emplace_back(value);
+    }
+
+    void push_back(T &&value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() noexcept {
+        const size_type chunk = (v_size - 1) / chunk_size;
+        if (v_chunks[chunk] != nullptr) {
+            v_chunks[chunk][(v_size - 1) % chunk_size].~value_type();
+        }
+        if (--v_size % chunk_size == 0) {
+            release_chunk(chunk);
+            v_chunks.pop_back();
+        }
+    }
+
+    void swap(sparse_chunk_vector &other) noexcept {
+        v_chunks.swap(other.v_chunks);
+        std::swap(v_size, other.v_size);
+    }
+};
+
+template <typename T, std::size_t chunk_size, typename Alloc>
+void swap(
+    sparse_chunk_vector<T, chunk_size, Alloc> &lhs,
+    sparse_chunk_vector<T, chunk_size, Alloc> &rhs
+) noexcept {
+    lhs.swap(rhs);
+}
+}  // namespace CustomVector
+
+#endif  // SPARSE_CHUNK_VECTOR_HPP
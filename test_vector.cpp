@@ -1,8 +1,30 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <list>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
 
 #ifdef TEST_CHUNK_VECTOR
+#include "chunk_algorithms.hpp"
+#include "chunk_channel.hpp"
+#include "chunk_ring.hpp"
+#include "chunk_soa_vector.hpp"
+#include "chunk_sort.hpp"
+#include "chunk_table.hpp"
 #include "chunk_vector.hpp"
+#include "chunk_vector_bool.hpp"
+#include "compressed_chunk_vector.hpp"
+#include "huge_page_allocator.hpp"
+#include "numa_allocator.hpp"
+#include "small_chunk_vector.hpp"
+#include "sorted_chunk_vector.hpp"
+#include "sparse_chunk_vector.hpp"
+#include "zoned_chunk_vector.hpp"
 template <typename T, typename Alloc = std::allocator<T>>
 using vector = CustomVector::chunk_vector<T, 4096 / sizeof(T), Alloc>;
 #endif
@@ -868,6 +890,36 @@ TEST_F(NonMemberTest, greater_or_equal) {
     EXPECT_FALSE(v_little >= v_1);
 }
 
+TEST_F(NonMemberTest, compare) {
+    EXPECT_EQ(compare(v_1, v_eq), 0);
+    EXPECT_GT(compare(v_1, v_little), 0);
+    EXPECT_LT(compare(v_1, v_greater), 0);
+    EXPECT_GT(compare(v_1, v_less), 0);
+    EXPECT_LT(compare(v_little, v_1), 0);
+}
+
+TEST_F(NonMemberTest, comparison_across_chunks) {
+    vector<int> lhs(3000, -1);
+    vector<int> rhs(3000, -1);
+    EXPECT_TRUE(lhs == rhs);
+    rhs[2500] = 1;
+    EXPECT_FALSE(lhs == rhs);
+    EXPECT_TRUE(lhs < rhs);
+    EXPECT_LT(compare(lhs, rhs), 0);
+    lhs[2500] = 2;
+    EXPECT_TRUE(rhs < lhs);
+    EXPECT_GT(compare(lhs, rhs), 0);
+
+    vector<std::string> strings(2000, "a");
+    vector<std::string> other = strings;
+    EXPECT_TRUE(strings == other);
+    EXPECT_EQ(compare(strings, other), 0);
+    other[1500] = "b";
+    EXPECT_FALSE(strings == other);
+    EXPECT_TRUE(strings < other);
+    EXPECT_LT(compare(strings, other), 0);
+}
+
 TEST_F(NonMemberTest, swap) {
     std::swap(v_1, v_eq);
     EXPECT_TRUE(v_1 == v_eq);
@@ -882,6 +934,2047 @@ TEST_F(NonMemberTest, swap) {
 }
 }  // namespace
 
+// Allocators testing
+namespace {
+std::uintptr_t huge_page_of(const void *p) {
+    return reinterpret_cast<std::uintptr_t>(p) / CustomVector::huge_page_size;
+}
+
+TEST(HugePageAllocatorTest, chunks_do_not_straddle_huge_pages) {
+    using huge_vector =
+        vector<test_int, CustomVector::huge_page_allocator<test_int>>;
+    constexpr std::size_t chunk = 4096 / sizeof(test_int);
+    huge_vector v;
+    for (int i = 0; i < 2000000; ++i) {
+        v.push_back(i);
+    }
+    for (std::size_t i = 0; i < v.size(); i += chunk) {
+        std::size_t last = std::min(i + chunk, v.size()) - 1;
+        EXPECT_EQ(huge_page_of(&v[i]), huge_page_of(&v[last]));
+        EXPECT_EQ(&v[last] - &v[i], static_cast<std::ptrdiff_t>(last - i));
+    }
+    for (std::size_t i = 0; i < v.size(); i += 997) {
+        EXPECT_EQ(v[i].m_value, static_cast<int>(i));
+    }
+}
+
+// Created before the pool and destroyed after the other statics at exit.
+CustomVector::chunk_vector<int, 1024, CustomVector::huge_page_allocator<int>>
+    static_huge_vector;
+
+TEST(HugePageAllocatorTest, vector_with_static_storage_outlives_pool) {
+    for (int i = 0; i < 5000; ++i) {
+        static_huge_vector.push_back(i);
+    }
+    EXPECT_EQ(static_huge_vector[4999], 4999);
+}
+
+TEST(HugePageAllocatorTest, reuses_freed_chunks) {
+    CustomVector::huge_page_allocator<int> alloc;
+    int *first = alloc.allocate(1024);
+    alloc.deallocate(first, 1024);
+    int *second = alloc.allocate(1024);
+    EXPECT_EQ(first, second);
+    alloc.deallocate(second, 1024);
+}
+
+TEST(HugePageAllocatorTest, large_blocks_are_huge_page_aligned) {
+    CustomVector::huge_page_allocator<char> alloc;
+    char *block = alloc.allocate(3 * CustomVector::huge_page_size);
+    EXPECT_EQ(
+        reinterpret_cast<std::uintptr_t>(block) % CustomVector::huge_page_size,
+        0
+    );
+    block[0] = 1;
+    block[3 * CustomVector::huge_page_size - 1] = 1;
+    alloc.deallocate(block, 3 * CustomVector::huge_page_size);
+}
+
+TEST(HugePageAllocatorTest, too_large_count_throws) {
+    CustomVector::huge_page_allocator<int> alloc;
+    EXPECT_THROW(
+        alloc.allocate(alloc.max_size() + 1), std::bad_array_new_length
+    );
+    EXPECT_THROW(
+        alloc.allocate(std::numeric_limits<std::size_t>::max()),
+        std::bad_array_new_length
+    );
+    CustomVector::huge_page_allocator<char> bytes;
+    EXPECT_THROW(
+        bytes.allocate(std::numeric_limits<std::size_t>::max()),
+        std::bad_array_new_length
+    );
+    EXPECT_THROW(
+        bytes.allocate(bytes.max_size() + 1), std::bad_array_new_length
+    );
+    EXPECT_THROW(
+        CustomVector::huge_page_pool::instance().allocate(
+            std::numeric_limits<std::size_t>::max() - 1
+        ),
+        std::bad_alloc
+    );
+}
+
+TEST(NumaAllocatorTest, every_policy_stores_elements) {
+    for (auto policy :
+         {CustomVector::numa_policy::first_touch,
+          CustomVector::numa_policy::interleave,
+          CustomVector::numa_policy::blocked}) {
+        CustomVector::numa_allocator<test_int> alloc(policy, 2);
+        vector<test_int, CustomVector::numa_allocator<test_int>> v(alloc);
+        for (int i = 0; i < 5000; ++i) {
+            v.push_back(i);
+        }
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            EXPECT_EQ(v[i].m_value, static_cast<int>(i));
+        }
+    }
+}
+
+TEST(NumaAllocatorTest, moved_from_vector_can_allocate) {
+    CustomVector::numa_allocator<test_int> alloc(
+        CustomVector::numa_policy::interleave
+    );
+    vector<test_int, CustomVector::numa_allocator<test_int>> v(alloc);
+    v.push_back(1);
+    auto moved(std::move(v));
+    v.push_back(2);
+    EXPECT_EQ(v[0].m_value, 2);
+    EXPECT_EQ(moved[0].m_value, 1);
+}
+
+TEST(NumaAllocatorTest, chunks_by_numa_node_covers_all_chunks) {
+    vector<test_int, CustomVector::numa_allocator<test_int>> v(
+        CustomVector::numa_allocator<test_int>(
+            CustomVector::numa_policy::interleave
+        )
+    );
+    v.resize(10000, 7);
+    auto chunks = CustomVector::chunks_by_numa_node(v);
+    EXPECT_GE(chunks.size(), CustomVector::numa_node_count());
+    std::vector<std::size_t> seen;
+    for (const auto &node_chunks : chunks) {
+        seen.insert(seen.end(), node_chunks.begin(), node_chunks.end());
+    }
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQ(seen.size(), v.chunk_count());
+    for (std::size_t i = 0; i < seen.size(); ++i) {
+        EXPECT_EQ(seen[i], i);
+    }
+}
+
+std::size_t mapping_count() {
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    std::size_t count = 0;
+    while (std::getline(maps, line)) {
+        ++count;
+    }
+    return count;
+}
+
+// One mapping per chunk would reach vm.max_map_count (65530 by default).
+TEST(NumaAllocatorTest, chunks_share_mappings) {
+    CustomVector::numa_allocator<int> alloc(
+        CustomVector::numa_policy::interleave
+    );
+    std::vector<int *> chunks(70000);
+    const std::size_t before = mapping_count();
+    for (auto &chunk : chunks) {
+        chunk = alloc.allocate(1024);
+    }
+    EXPECT_LT(mapping_count(), before + 100);
+    for (auto *chunk : chunks) {
+        alloc.deallocate(chunk, 1024);
+    }
+    int *reused = alloc.allocate(1024);
+    EXPECT_NE(std::find(chunks.begin(), chunks.end(), reused), chunks.end());
+    alloc.deallocate(reused, 1024);
+}
+
+TEST(NumaAllocatorTest, node_list_can_be_sparse) {
+    EXPECT_EQ(
+        CustomVector::detail::parse_node_list("0-3,5"),
+        (std::vector<int>{0, 1, 2, 3, 5})
+    );
+    EXPECT_EQ(
+        CustomVector::detail::parse_node_list("2,4-5"),
+        (std::vector<int>{2, 4, 5})
+    );
+    const std::vector<int> online = CustomVector::numa_online_nodes();
+    EXPECT_EQ(online.size(), CustomVector::numa_node_count());
+    EXPECT_TRUE(std::is_sorted(online.begin(), online.end()));
+}
+
+// Three-page chunks, which no other test frees, so that none are reused.
+TEST(NumaAllocatorTest, untouched_chunks_are_not_faulted_in) {
+    CustomVector::chunk_vector<int, 3072, CustomVector::numa_allocator<int>>
+        v;
+    v.grow_by(8 * 3072);
+    auto chunks = CustomVector::chunks_by_numa_node(v);
+    std::size_t seen = 0;
+    for (const auto &node_chunks : chunks) {
+        seen += node_chunks.size();
+    }
+    EXPECT_EQ(seen, v.chunk_count());
+    for (std::size_t chunk = 0; chunk < v.chunk_count(); ++chunk) {
+        EXPECT_EQ(CustomVector::numa_node_of(v.chunk_data(chunk)), -1);
+        unsigned char resident = 1;
+        ASSERT_EQ(mincore(v.chunk_data(chunk), 1, &resident), 0);
+        EXPECT_EQ(resident & 1, 0);
+    }
+}
+}  // namespace
+
+// Chunk access testing
+namespace {
+TEST(ChunkAccessTest, chunks_cover_elements_in_order) {
+    constexpr std::size_t chunk = 4096 / sizeof(test_int);
+    vector<test_int> v;
+    EXPECT_EQ(v.chunk_count(), 0);
+    for (int i = 0; i < static_cast<int>(2 * chunk + 5); ++i) {
+        v.push_back(i);
+    }
+    v.reserve(10 * chunk);
+    ASSERT_EQ(v.chunk_count(), 3);
+    EXPECT_EQ(v.chunk_length(0), chunk);
+    EXPECT_EQ(v.chunk_length(2), 5);
+    int expected = 0;
+    v.for_each_chunk([&](test_int *data, std::size_t length) {
+        for (std::size_t i = 0; i < length; ++i) {
+            EXPECT_EQ(data[i].m_value, expected++);
+        }
+    });
+    EXPECT_EQ(expected, static_cast<int>(v.size()));
+}
+
+TEST(ChunkAccessTest, chunk_ranges_split_the_work) {
+    const vector<test_int> v(10000, 1);
+    std::size_t middle = v.chunk_count() / 2;
+    std::size_t total = 0;
+    auto count = [&](const test_int *, std::size_t length) {
+        total += length;
+    };
+    v.for_each_chunk(0, middle, count);
+    v.for_each_chunk(middle, v.chunk_count(), count);
+    EXPECT_EQ(total, v.size());
+    EXPECT_EQ(v.chunk_data(1), &v[4096 / sizeof(test_int)]);
+}
+
+TEST(ChunkAccessTest, append_takes_chunks) {
+    constexpr std::size_t chunk = 4096 / sizeof(test_int);
+    vector<test_int> v;
+    vector<test_int> other;
+    for (int i = 0; i < static_cast<int>(2 * chunk); ++i) {
+        v.push_back(i);
+    }
+    for (int i = 0; i < static_cast<int>(chunk + 3); ++i) {
+        other.push_back(static_cast<int>(2 * chunk) + i);
+    }
+    test_int *moved_chunk = other.chunk_data(1);
+    v.append(std::move(other));
+    EXPECT_TRUE(other.empty());
+    ASSERT_EQ(v.size(), 3 * chunk + 3);
+    EXPECT_EQ(v.chunk_data(3), moved_chunk);
+    v.append(vector<test_int>(5, 1));
+    ASSERT_EQ(v.size(), 3 * chunk + 8);
+    for (int i = 0; i < static_cast<int>(3 * chunk + 3); ++i) {
+        EXPECT_EQ(v[i].m_value, i);
+    }
+    EXPECT_EQ(v.back().m_value, 1);
+}
+
+TEST(ChunkAccessTest, splice) {
+    constexpr std::size_t chunk = 4096 / sizeof(test_int);
+    vector<test_int> v(2 * chunk + 1, 0);
+    vector<test_int> aligned(chunk, 1);
+    test_int *moved_chunk = aligned.chunk_data(0);
+    auto it = v.splice(v.begin() + chunk, std::move(aligned));
+    EXPECT_EQ(it - v.begin(), static_cast<std::ptrdiff_t>(chunk));
+    EXPECT_EQ(v.chunk_data(1), moved_chunk);
+    EXPECT_TRUE(aligned.empty());
+    v.splice(v.begin() + 1, vector<test_int>(2, 2));
+    ASSERT_EQ(v.size(), 3 * chunk + 3);
+    EXPECT_EQ(v[0].m_value, 0);
+    EXPECT_EQ(v[1].m_value, 2);
+    EXPECT_EQ(v[2].m_value, 2);
+    EXPECT_EQ(v[chunk + 1].m_value, 0);
+    EXPECT_EQ(v[chunk + 2].m_value, 1);
+    EXPECT_EQ(v[2 * chunk + 2].m_value, 0);
+}
+
+TEST(ChunkAccessTest, splice_into_itself) {
+    vector<test_int> v;
+    for (int i = 0; i < 6; ++i) {
+        v.push_back(i);
+    }
+    auto it = v.splice(v.cbegin() + 1, std::move(v));
+    EXPECT_EQ(it - v.begin(), 1);
+    ASSERT_EQ(v.size(), 6);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(v[i].m_value, i);
+    }
+    v.splice(v.cend(), std::move(v));
+    EXPECT_EQ(v.size(), 6);
+}
+
+TEST(ChunkAccessTest, split_at) {
+    constexpr std::size_t chunk = 4096 / sizeof(test_int);
+    vector<test_int> v;
+    for (int i = 0; i < static_cast<int>(3 * chunk); ++i) {
+        v.push_back(i);
+    }
+    test_int *moved_chunk = v.chunk_data(2);
+    vector<test_int> tail = v.split_at(2 * chunk);
+    ASSERT_EQ(v.size(), 2 * chunk);
+    ASSERT_EQ(tail.size(), chunk);
+    EXPECT_EQ(tail.chunk_data(0), moved_chunk);
+    EXPECT_EQ(tail[0].m_value, static_cast<int>(2 * chunk));
+
+    vector<test_int> middle = v.split_at(10);
+    ASSERT_EQ(v.size(), 10);
+    ASSERT_EQ(middle.size(), 2 * chunk - 10);
+    EXPECT_EQ(middle[0].m_value, 10);
+    EXPECT_EQ(middle.back().m_value, static_cast<int>(2 * chunk - 1));
+    EXPECT_TRUE(v.split_at(10).empty());
+    EXPECT_THROW(v.split_at(11), std::out_of_range);
+    v.push_back(10);
+    EXPECT_EQ(v.back().m_value, 10);
+}
+}  // namespace
+
+// Chunk algorithms testing
+namespace {
+class ChunkAlgorithmsTest : public testing::Test {
+protected:
+    using level = CustomVector::simd::level;
+    vector<int> v_int;
+    vector<float> v_float;
+
+    ChunkAlgorithmsTest() {
+        for (int i = 0; i < 3003; ++i) {
+            v_int.push_back((i * 7919) % 1009 - 504);
+            v_float.push_back(static_cast<float>((i * 7919) % 1009) / 4);
+        }
+    }
+
+    ~ChunkAlgorithmsTest() override {
+        CustomVector::simd::set_level(level::avx2);
+    }
+
+    template <typename F>
+    static void for_each_level(F f) {
+        for (level l : {level::scalar, level::sse2, level::avx2}) {
+            CustomVector::simd::set_level(l);
+            f();
+        }
+    }
+};
+
+TEST_F(ChunkAlgorithmsTest, reductions) {
+    for_each_level([&] {
+        EXPECT_EQ(
+            CustomVector::sum(v_int),
+            std::accumulate(v_int.begin(), v_int.end(), 0LL)
+        );
+        EXPECT_FLOAT_EQ(
+            CustomVector::sum(v_float),
+            std::accumulate(v_float.begin(), v_float.end(), 0.0f)
+        );
+        EXPECT_EQ(
+            CustomVector::min_value(v_int),
+            *std::min_element(v_int.begin(), v_int.end())
+        );
+        EXPECT_EQ(
+            CustomVector::max_value(v_int),
+            *std::max_element(v_int.begin(), v_int.end())
+        );
+        EXPECT_EQ(
+            CustomVector::max_value(v_float),
+            *std::max_element(v_float.begin(), v_float.end())
+        );
+    });
+}
+
+TEST_F(ChunkAlgorithmsTest, count_and_find) {
+    for_each_level([&] {
+        for (int value : {-504, 0, 17, 504, 100000}) {
+            EXPECT_EQ(
+                CustomVector::count(v_int, value),
+                std::count(v_int.begin(), v_int.end(), value)
+            );
+            EXPECT_EQ(
+                CustomVector::find(v_int, value),
+                std::find(v_int.begin(), v_int.end(), value)
+            );
+        }
+        EXPECT_EQ(
+            CustomVector::find(v_float, v_float.back()) - v_float.begin(),
+            std::find(v_float.begin(), v_float.end(), v_float.back()) -
+                v_float.begin()
+        );
+        EXPECT_EQ(
+            CustomVector::find_if(v_int, [](int x) { return x > 500; }),
+            std::find_if(v_int.begin(), v_int.end(), [](int x) {
+                return x > 500;
+            })
+        );
+    });
+}
+
+TEST_F(ChunkAlgorithmsTest, comparison) {
+    for_each_level([&] {
+        vector<int> copy = v_int;
+        EXPECT_TRUE(CustomVector::equal(v_int, copy));
+        EXPECT_FALSE(CustomVector::lexicographical_compare(v_int, copy));
+        copy[2500] += 1;
+        EXPECT_FALSE(CustomVector::equal(v_int, copy));
+        EXPECT_TRUE(CustomVector::lexicographical_compare(v_int, copy));
+        EXPECT_FALSE(CustomVector::lexicographical_compare(copy, v_int));
+        copy[2500] -= 1;
+        copy.pop_back();
+        EXPECT_FALSE(CustomVector::equal(v_int, copy));
+        EXPECT_TRUE(CustomVector::lexicographical_compare(copy, v_int));
+    });
+}
+}  // namespace
+
+// Chunk sort testing
+namespace {
+TEST(ChunkSortTest, sort) {
+    for (std::size_t size : {0, 1, 1000, 1024, 2048, 10000}) {
+        for (std::size_t threads : {1, 4}) {
+            vector<int> v;
+            std::vector<int> expected;
+            for (std::size_t i = 0; i < size; ++i) {
+                v.push_back(static_cast<int>(i * 7919 % 1009));
+                expected.push_back(v.back());
+            }
+            std::sort(expected.begin(), expected.end());
+            CustomVector::sort(v, std::less<>(), threads);
+            ASSERT_EQ(v.size(), size);
+            EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+        }
+    }
+}
+
+TEST(ChunkSortTest, sort_with_comparator) {
+    vector<std::string> v;
+    for (int i = 0; i < 3000; ++i) {
+        v.push_back(std::to_string(i * 7919 % 3001));
+    }
+    CustomVector::sort(v, std::greater<>(), 2);
+    EXPECT_TRUE(std::is_sorted(v.begin(), v.end(), std::greater<>()));
+    EXPECT_EQ(v.size(), 3000);
+}
+
+TEST(ChunkSortTest, stable_sort) {
+    vector<std::pair<int, int>> v;
+    for (int i = 0; i < 5000; ++i) {
+        v.emplace_back(i * 7919 % 10, i);
+    }
+    CustomVector::stable_sort(
+        v, [](const auto &a, const auto &b) { return a.first < b.first; }, 3
+    );
+    for (std::size_t i = 1; i < v.size(); ++i) {
+        ASSERT_TRUE(
+            v[i - 1].first < v[i].first ||
+            (v[i - 1].first == v[i].first && v[i - 1].second < v[i].second)
+        );
+    }
+}
+
+// The first limit is reached while the chunks are sorted, the second one
+// while they are merged.
+TEST(ChunkSortTest, comparator_exception_reaches_caller) {
+    for (int limit : {5000, 140000}) {
+        for (std::size_t threads : {1, 4}) {
+            vector<int> v;
+            for (int i = 0; i < 10000; ++i) {
+                v.push_back(i * 7919 % 1009);
+            }
+            std::atomic<int> calls{0};
+            const auto comp = [&calls, limit](int a, int b) {
+                if (++calls == limit) {
+                    throw std::runtime_error("comparator");
+                }
+                return a < b;
+            };
+            EXPECT_THROW(
+                CustomVector::sort(v, comp, threads), std::runtime_error
+            );
+            EXPECT_EQ(v.size(), 10000);
+        }
+    }
+}
+
+TEST(ChunkSortTest, radix_sort) {
+    for (std::size_t threads : {1, 3}) {
+        vector<int> v;
+        std::vector<int> expected;
+        for (int i = 0; i < 5000; ++i) {
+            v.push_back((i * 7919 % 10007 - 5000) * 40503);
+            expected.push_back(v.back());
+        }
+        std::sort(expected.begin(), expected.end());
+        CustomVector::radix_sort(v, [](int x) { return x; }, threads);
+        EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+    }
+
+    vector<double> doubles;
+    for (int i = 0; i < 3000; ++i) {
+        doubles.push_back((i * 7919 % 3001 - 1500) / 7.0);
+    }
+    doubles.push_back(-0.0);
+    CustomVector::radix_sort(doubles);
+    EXPECT_TRUE(std::is_sorted(doubles.begin(), doubles.end()));
+
+    vector<int> empty;
+    CustomVector::radix_sort(empty);
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(ChunkSortTest, radix_sort_by_key) {
+    vector<std::pair<unsigned, int>> v;
+    for (int i = 0; i < 5000; ++i) {
+        v.emplace_back(i * 7919u % 700u * 100003u, i);
+    }
+    CustomVector::radix_sort(v, [](const auto &p) { return p.first; }, 2);
+    for (std::size_t i = 1; i < v.size(); ++i) {
+        ASSERT_TRUE(
+            v[i - 1].first < v[i].first ||
+            (v[i - 1].first == v[i].first && v[i - 1].second < v[i].second)
+        );
+    }
+}
+}  // namespace
+
+// Chunk ring testing
+namespace {
+template <typename T, typename Alloc = std::allocator<T>>
+using ring = CustomVector::chunk_ring<T, 4096 / sizeof(T), Alloc>;
+
+template <typename T>
+struct CountingAlloc {
+    using value_type = T;
+    std::size_t *allocations;
+
+    explicit CountingAlloc(std::size_t *allocations)
+        : allocations(allocations) {
+    }
+
+    T *allocate(size_t n) {
+        ++*allocations;
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t) {
+        ::operator delete(ptr);
+    }
+
+    bool operator==(const CountingAlloc &other) const {
+        return allocations == other.allocations;
+    }
+};
+
+TEST(ChunkRingTest, fifo_order) {
+    ring<test_int> queue;
+    int pushed = 0;
+    int popped = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 1500; ++i) {
+            queue.push_back(pushed++);
+        }
+        EXPECT_EQ(queue.back().m_value, pushed - 1);
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_EQ(queue.front().m_value, popped++);
+            queue.pop_front();
+        }
+        EXPECT_EQ(queue.size(), static_cast<std::size_t>(pushed - popped));
+        EXPECT_EQ(queue[1].m_value, popped + 1);
+    }
+    ring<test_int> copy = queue;
+    while (!queue.empty()) {
+        EXPECT_EQ(queue.front().m_value, copy.front().m_value);
+        queue.pop_front();
+        copy.pop_front();
+    }
+    EXPECT_TRUE(copy.empty());
+}
+
+TEST(ChunkRingTest, steady_state_does_not_allocate) {
+    std::size_t allocations = 0;
+    ring<test_int, CountingAlloc<test_int>> queue(
+        std::numeric_limits<std::size_t>::max(),
+        CountingAlloc<test_int>(&allocations)
+    );
+    for (int i = 0; i < 3000; ++i) {
+        queue.push_back(i);
+    }
+    // With the front in the middle of a chunk one more chunk is needed.
+    for (int i = 0; i < 3000; ++i) {
+        queue.pop_front();
+        queue.push_back(i);
+    }
+    const std::size_t warm = allocations;
+    for (int i = 0; i < 100000; ++i) {
+        queue.pop_front();
+        queue.push_back(i);
+    }
+    EXPECT_EQ(allocations, warm);
+    EXPECT_EQ(queue.size(), 3000);
+    queue.clear();
+    queue.shrink_to_fit();
+    EXPECT_EQ(queue.capacity(), 0);
+}
+
+TEST(ChunkRingTest, bounded) {
+    ring<test_int> queue(3);
+    EXPECT_TRUE(queue.try_push_back(1));
+    EXPECT_TRUE(queue.try_push_back(2));
+    EXPECT_TRUE(queue.try_emplace_back(3));
+    EXPECT_TRUE(queue.full());
+    EXPECT_FALSE(queue.try_push_back(4));
+    EXPECT_EQ(queue.size(), 3);
+    queue.pop_front();
+    EXPECT_TRUE(queue.try_push_back(4));
+    EXPECT_EQ(queue.at(2).m_value, 4);
+    EXPECT_THROW(queue.at(3), std::out_of_range);
+}
+}  // namespace
+
+// Chunk channel testing
+namespace {
+template <typename T>
+using channel = CustomVector::chunk_channel<T, 4096 / sizeof(T)>;
+
+TEST(ChunkChannelTest, delivers_in_order) {
+    channel<test_int> ch(4);
+    for (int i = 0; i < 3000; ++i) {
+        ch.push(i);
+    }
+    ch.close();
+    int expected = 0;
+    test_int value(0);
+    ASSERT_TRUE(ch.pop(value));
+    EXPECT_EQ(value.m_value, expected++);
+    while (ch.consume([&](test_int *data, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(data[i].m_value, expected++);
+        }
+    })) {
+    }
+    EXPECT_EQ(expected, 3000);
+    EXPECT_FALSE(ch.pop(value));
+}
+
+TEST(ChunkChannelTest, producer_and_consumer_threads) {
+    constexpr int count = 200000;
+    channel<int> ch(3);
+    std::thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            ch.push(i);
+        }
+        ch.close();
+    });
+    long long sum = 0;
+    int received = 0;
+    bool ordered = true;
+    while (ch.consume([&](int *data, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            ordered = ordered && data[i] == received;
+            sum += data[i];
+            ++received;
+        }
+    })) {
+    }
+    producer.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(received, count);
+    EXPECT_EQ(sum, 1LL * count * (count - 1) / 2);
+}
+
+TEST(ChunkChannelTest, destroys_unconsumed_elements) {
+    channel<std::string> ch;
+    for (int i = 0; i < 1000; ++i) {
+        ch.push(std::string(100, 'a'));
+    }
+    ch.flush();
+    ch.push("not published");
+    std::string value;
+    EXPECT_TRUE(ch.pop(value));
+    EXPECT_EQ(value, std::string(100, 'a'));
+    EXPECT_TRUE(ch.try_consume([](std::string *, std::size_t n) {
+        EXPECT_GT(n, 0);
+    }));
+}
+}  // namespace
+
+// Small chunk vector testing
+namespace {
+template <typename T, std::size_t inline_capacity>
+using small_vector = CustomVector::
+    small_chunk_vector<T, inline_capacity, 4096 / sizeof(T)>;
+
+TEST(SmallChunkVectorTest, stays_inline) {
+    small_vector<int, 16> v;
+    EXPECT_EQ(sizeof v, 16 * sizeof(int) + sizeof(std::size_t));
+    for (int i = 0; i < 16; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v.size(), 16);
+    EXPECT_EQ(v.capacity(), 16);
+    EXPECT_EQ(v.back(), 15);
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 120);
+}
+
+TEST(SmallChunkVectorTest, moves_to_chunks_and_back) {
+    small_vector<test_int, 4> v;
+    for (int i = 0; i < 3000; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_FALSE(v.is_inline());
+    ASSERT_EQ(v.size(), 3000);
+    for (int i = 0; i < 3000; ++i) {
+        ASSERT_EQ(v[i].m_value, i);
+    }
+    v.resize(3);
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.is_inline());
+    ASSERT_EQ(v.size(), 3);
+    EXPECT_EQ(v[2].m_value, 2);
+    EXPECT_THROW(v.at(3), std::out_of_range);
+}
+
+TEST(SmallChunkVectorTest, copy_move_and_swap) {
+    small_vector<std::string, 2> small = {"a", "b"};
+    small_vector<std::string, 2> big;
+    for (int i = 0; i < 100; ++i) {
+        big.push_back(std::to_string(i));
+    }
+    small_vector<std::string, 2> copy = big;
+    EXPECT_TRUE(copy == big);
+    small_vector<std::string, 2> moved = std::move(copy);
+    EXPECT_TRUE(moved == big);
+    EXPECT_TRUE(copy.empty());
+    moved.swap(small);
+    EXPECT_TRUE(moved.is_inline());
+    EXPECT_EQ(moved[1], "b");
+    EXPECT_TRUE(small == big);
+    small = moved;
+    EXPECT_TRUE(small == moved);
+    EXPECT_FALSE(small != moved);
+}
+
+// Copies its value on move, and throws once moves_left moves were made.
+struct throwing_move {
+    static inline int moves_left = -1;
+    std::string value;
+
+    throwing_move(int v) : value(std::to_string(v)) {
+    }
+
+    throwing_move(const throwing_move &) = default;
+
+    throwing_move(throwing_move &&other) : value(other.value) {
+        if (moves_left-- == 0) {
+            throw std::runtime_error("move");
+        }
+    }
+};
+
+TEST(SmallChunkVectorTest, throwing_move_in_shrink_to_fit) {
+    small_vector<throwing_move, 4> v;
+    for (int i = 0; i < 8; ++i) {
+        v.emplace_back(i);
+    }
+    v.resize(3, throwing_move(0));
+    throwing_move::moves_left = 1;
+    EXPECT_THROW(v.shrink_to_fit(), std::runtime_error);
+    throwing_move::moves_left = -1;
+    EXPECT_FALSE(v.is_inline());
+    ASSERT_EQ(v.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(v[i].value, std::to_string(i));
+    }
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v[2].value, "2");
+}
+
+TEST(SmallChunkVectorTest, element_of_itself_survives_move_to_chunks) {
+    small_vector<std::string, 2> v;
+    v.push_back(std::string(32, 'a'));
+    v.push_back(std::string(32, 'b'));
+    v.push_back(v[0]);
+    ASSERT_EQ(v.size(), 3);
+    EXPECT_EQ(v[0], std::string(32, 'a'));
+    EXPECT_EQ(v[2], std::string(32, 'a'));
+
+    small_vector<std::string, 2> resized = {std::string(32, 'c')};
+    resized.resize(5, resized[0]);
+    ASSERT_EQ(resized.size(), 5);
+    EXPECT_EQ(resized[4], std::string(32, 'c'));
+    v.emplace_back(v[1]);
+    EXPECT_EQ(v[3], std::string(32, 'b'));
+}
+}  // namespace
+
+// Adaptive first chunk testing
+namespace {
+template <typename T, std::size_t first_chunk_size = 4>
+using adaptive_vector = CustomVector::
+    chunk_vector<T, 64, std::allocator<T>, first_chunk_size>;
+
+TEST(AdaptiveFirstChunkTest, first_chunk_doubles_up_to_chunk_size) {
+    adaptive_vector<test_int> v;
+    EXPECT_EQ(v.capacity(), 0);
+    std::vector<std::size_t> capacities;
+    for (int i = 0; i < 200; ++i) {
+        v.push_back(i);
+        if (capacities.empty() || capacities.back() != v.capacity()) {
+            capacities.push_back(v.capacity());
+        }
+    }
+    EXPECT_EQ(
+        capacities, (std::vector<std::size_t>{4, 8, 16, 32, 64, 128, 192, 256})
+    );
+    EXPECT_EQ(v.chunk_count(), 4);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_EQ(v[i].m_value, i);
+    }
+    // Without a smaller first chunk nothing changes.
+    EXPECT_EQ(sizeof(adaptive_vector<test_int, 64>), 32);
+
+    adaptive_vector<test_int> reserved;
+    reserved.reserve(10);
+    EXPECT_EQ(reserved.capacity(), 16);
+}
+
+TEST(AdaptiveFirstChunkTest, shrink_to_fit_reallocates_single_chunk) {
+    adaptive_vector<std::string> v;
+    for (int i = 0; i < 100; ++i) {
+        v.push_back(std::to_string(i));
+    }
+    v.resize(5);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 8);
+    EXPECT_EQ(v[4], "4");
+    v.clear();
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 0);
+    v.push_back("again");
+    EXPECT_EQ(v.capacity(), 4);
+}
+
+TEST(AdaptiveFirstChunkTest, chunk_transfer_and_swap) {
+    adaptive_vector<std::string> small = {"a", "b"};
+    adaptive_vector<std::string> big;
+    for (int i = 0; i < 128; ++i) {
+        big.push_back(std::to_string(i));
+    }
+    // The small chunk of small can not be handed over, the full chunks of
+    // big can.
+    adaptive_vector<std::string> joined = big;
+    joined.append(std::move(small));
+    ASSERT_EQ(joined.size(), 130);
+    EXPECT_EQ(joined.back(), "b");
+    adaptive_vector<std::string> tail = joined.split_at(64);
+    EXPECT_EQ(tail.size(), 66);
+    EXPECT_EQ(tail[0], "64");
+    EXPECT_EQ(joined.capacity(), 64);
+
+    adaptive_vector<std::string> few = {"x"};
+    few.swap(tail);
+    EXPECT_EQ(few.size(), 66);
+    EXPECT_EQ(tail.capacity(), 4);
+    adaptive_vector<std::string> moved = std::move(tail);
+    EXPECT_EQ(moved[0], "x");
+    EXPECT_EQ(tail.capacity(), 0);
+    tail = std::move(few);
+    EXPECT_EQ(tail[65], "b");
+}
+
+TEST(AdaptiveFirstChunkTest, own_element_survives_first_chunk_growth) {
+    // Each doubling frees the chunk the argument lies in.
+    const std::string first(32, 'a');
+    adaptive_vector<std::string, 2> pushed = {first};
+    adaptive_vector<std::string, 2> emplaced = {first};
+    adaptive_vector<std::string, 2> inserted = {first};
+    adaptive_vector<std::string, 2> emplaced_at = {first};
+    adaptive_vector<std::string, 2> filled = {first};
+    adaptive_vector<std::string, 2> resized = {first};
+    for (std::size_t i = 1; i < 100; ++i) {
+        pushed.push_back(pushed[0]);
+        emplaced.emplace_back(emplaced[0]);
+        inserted.insert(inserted.begin() + 1, inserted[0]);
+        emplaced_at.emplace(emplaced_at.begin() + 1, emplaced_at[0]);
+        filled.insert(filled.end(), 1, filled[0]);
+        resized.resize(i + 1, resized[0]);
+    }
+    for (const auto *v :
+         {&pushed, &emplaced, &inserted, &emplaced_at, &filled, &resized}) {
+        ASSERT_EQ(v->size(), 100);
+        EXPECT_EQ(std::count(v->begin(), v->end(), first), 100);
+    }
+}
+}  // namespace
+
+// Chunk table testing
+namespace {
+template <typename T, typename ChunkTable>
+using table_vector = CustomVector::
+    chunk_vector<T, 16, std::allocator<T>, 16, ChunkTable>;
+
+TEST(ChunkTableTest, inline_table_spills_to_heap) {
+    using inline_vector =
+        table_vector<test_int, CustomVector::inline_chunk_table<4>>;
+    EXPECT_EQ(sizeof(inline_vector), 32 + 4 * sizeof(test_int *) + 8);
+    inline_vector v;
+    for (int i = 0; i < 200; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_EQ(v.chunk_count(), 13);
+    for (int i = 0; i < 200; ++i) {
+        ASSERT_EQ(v[i].m_value, i);
+    }
+    v.erase(v.begin() + 10, v.begin() + 150);
+    ASSERT_EQ(v.size(), 60);
+    EXPECT_EQ(v[10].m_value, 150);
+    v.resize(20);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 32);
+    EXPECT_EQ(v.back().m_value, 159);
+}
+
+TEST(ChunkTableTest, chunk_transfer_across_inline_boundary) {
+    using inline_vector =
+        table_vector<std::string, CustomVector::inline_chunk_table<2>>;
+    inline_vector front;
+    inline_vector back;
+    for (int i = 0; i < 48; ++i) {
+        front.push_back(std::to_string(i));
+        back.push_back(std::to_string(100 + i));
+    }
+    front.splice(front.begin() + 16, std::move(back));
+    ASSERT_EQ(front.size(), 96);
+    EXPECT_EQ(front[15], "15");
+    EXPECT_EQ(front[16], "100");
+    EXPECT_EQ(front[64], "16");
+    inline_vector tail = front.split_at(32);
+    EXPECT_EQ(tail.size(), 64);
+    EXPECT_EQ(tail[0], "116");
+    front.append(std::move(tail));
+    EXPECT_EQ(front.size(), 96);
+    EXPECT_EQ(front.back(), "47");
+    inline_vector moved = std::move(front);
+    EXPECT_EQ(moved[64], "16");
+    EXPECT_TRUE(front.empty());
+    front.swap(moved);
+    EXPECT_EQ(front[95], "47");
+}
+
+TEST(ChunkTableTest, fixed_table_is_bounded) {
+    using fixed_vector =
+        table_vector<test_int, CustomVector::fixed_chunk_table<4>>;
+    EXPECT_EQ(sizeof(fixed_vector), 8 + 4 * sizeof(test_int *) + 8);
+    fixed_vector v;
+    EXPECT_EQ(v.max_size(), 64);
+    for (int i = 0; i < 64; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_THROW(v.push_back(64), std::length_error);
+    EXPECT_THROW(v.reserve(65), std::length_error);
+    ASSERT_EQ(v.size(), 64);
+    EXPECT_EQ(v.back().m_value, 63);
+    fixed_vector copy = v;
+    EXPECT_EQ(copy.size(), 64);
+    EXPECT_EQ(copy[40].m_value, 40);
+}
+
+TEST(ChunkTableTest, append_into_full_fixed_table) {
+    using fixed_vector = CustomVector::chunk_vector<
+        test_int, 4, std::allocator<test_int>, 4,
+        CustomVector::fixed_chunk_table<4>>;
+    fixed_vector v(4, 0);
+    v.reserve(12);
+    fixed_vector other(4, 1);
+    other.reserve(8);
+    v.append(std::move(other));
+    ASSERT_EQ(v.size(), 8);
+    EXPECT_EQ(v[3].m_value, 0);
+    EXPECT_EQ(v[4].m_value, 1);
+    EXPECT_EQ(v.capacity(), 16);
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(other.capacity(), 4);
+    other.assign(12, 2);
+    EXPECT_THROW(v.append(std::move(other)), std::length_error);
+    EXPECT_EQ(v.size(), 8);
+    EXPECT_EQ(other.size(), 12);
+    EXPECT_EQ(other[11].m_value, 2);
+}
+
+TEST(ChunkTableTest, splice_into_full_fixed_table) {
+    using fixed_vector =
+        table_vector<test_int, CustomVector::fixed_chunk_table<4>>;
+    fixed_vector v(32, 0);
+    fixed_vector other(16, 1);
+    other.reserve(48);
+    v.splice(v.begin() + 16, std::move(other));
+    ASSERT_EQ(v.size(), 48);
+    EXPECT_EQ(v[15].m_value, 0);
+    EXPECT_EQ(v[16].m_value, 1);
+    EXPECT_EQ(v[32].m_value, 0);
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(other.capacity(), 32);
+    other.assign(32, 2);
+    EXPECT_THROW(v.splice(v.begin(), std::move(other)), std::length_error);
+    EXPECT_EQ(v.size(), 48);
+    EXPECT_EQ(v[16].m_value, 1);
+    EXPECT_EQ(other.size(), 32);
+    EXPECT_EQ(other[31].m_value, 2);
+}
+}  // namespace
+
+// Trivially relocatable elements testing
+namespace {
+// Counts the moves chunk_vector makes, which must be none for a trivially
+// relocatable type.
+struct relocatable_handle {
+    static inline int moves = 0;
+    std::unique_ptr<int> value;
+
+    relocatable_handle(int v) : value(std::make_unique<int>(v)) {
+    }
+
+    relocatable_handle(relocatable_handle &&other) noexcept
+        : value(std::move(other.value)) {
+        ++moves;
+    }
+
+    relocatable_handle &operator=(relocatable_handle &&other) noexcept {
+        value = std::move(other.value);
+        ++moves;
+        return *this;
+    }
+};
+}  // namespace
+
+template <>
+struct CustomVector::is_trivially_relocatable<relocatable_handle>
+    : std::true_type {};
+
+namespace {
+// Relocatable, with a copy that throws once copies_left copies were made.
+struct throwing_handle {
+    static inline int copies_left = 0;
+    std::unique_ptr<int> value;
+
+    throwing_handle(int v) : value(std::make_unique<int>(v)) {
+    }
+
+    throwing_handle(const throwing_handle &other) {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("copy");
+        }
+        value = std::make_unique<int>(*other.value);
+    }
+
+    throwing_handle &operator=(const throwing_handle &other) {
+        value = std::make_unique<int>(*other.value);
+        return *this;
+    }
+};
+}  // namespace
+
+template <>
+struct CustomVector::is_trivially_relocatable<throwing_handle>
+    : std::true_type {};
+
+namespace {
+TEST(RelocationTest, traits) {
+    EXPECT_TRUE(CustomVector::is_trivially_relocatable_v<int>);
+    EXPECT_TRUE(
+        CustomVector::is_trivially_relocatable_v<std::unique_ptr<test_int>>
+    );
+    EXPECT_TRUE((CustomVector::is_trivially_relocatable_v<
+                 std::pair<std::shared_ptr<int>, std::vector<int>>>));
+    EXPECT_FALSE(CustomVector::is_trivially_relocatable_v<std::list<int>>);
+}
+
+TEST(RelocationTest, shifting_does_not_move) {
+    vector<relocatable_handle> v;
+    for (int i = 0; i < 3000; ++i) {
+        v.emplace_back(i);
+    }
+    relocatable_handle::moves = 0;
+    v.emplace(v.begin() + 10, -1);
+    v.insert(v.begin(), relocatable_handle(-2));
+    v.erase(v.begin() + 5, v.begin() + 1500);
+    v.erase(v.begin() + 1);
+    EXPECT_EQ(relocatable_handle::moves, 1);
+    ASSERT_EQ(v.size(), 1506);
+    EXPECT_EQ(*v[0].value, -2);
+    EXPECT_EQ(*v[1].value, 1);
+    EXPECT_EQ(*v[3].value, 3);
+    EXPECT_EQ(*v[4].value, 1498);
+    EXPECT_EQ(*v.back().value, 2999);
+}
+
+TEST(RelocationTest, throwing_insert_leaves_vector_unchanged) {
+    vector<throwing_handle> v;
+    for (int i = 0; i < 2000; ++i) {
+        v.emplace_back(i);
+    }
+    const throwing_handle value(-1);
+    throwing_handle::copies_left = 3;
+    const std::vector<throwing_handle> values(3, value);
+    const auto unchanged = [&v] {
+        ASSERT_EQ(v.size(), 2000);
+        for (int i = 0; i < 2000; ++i) {
+            ASSERT_EQ(*v[i].value, i);
+        }
+    };
+    throwing_handle::copies_left = 0;
+    EXPECT_THROW(v.insert(v.begin() + 10, value), std::runtime_error);
+    unchanged();
+    throwing_handle::copies_left = 0;
+    EXPECT_THROW(v.emplace(v.begin() + 10, value), std::runtime_error);
+    unchanged();
+    throwing_handle::copies_left = 2;
+    EXPECT_THROW(v.insert(v.begin() + 1020, 3, value), std::runtime_error);
+    unchanged();
+    throwing_handle::copies_left = 1;
+    EXPECT_THROW(
+        v.insert(v.begin(), values.begin(), values.end()), std::runtime_error
+    );
+    unchanged();
+}
+
+TEST(RelocationTest, transfer_between_allocators_does_not_move) {
+    std::size_t first_allocations = 0;
+    std::size_t second_allocations = 0;
+    const CountingAlloc<relocatable_handle> first_alloc(&first_allocations);
+    const CountingAlloc<relocatable_handle> second_alloc(&second_allocations);
+    using handle_vector =
+        vector<relocatable_handle, CountingAlloc<relocatable_handle>>;
+    handle_vector first(first_alloc);
+    handle_vector second(second_alloc);
+    for (int i = 0; i < 1000; ++i) {
+        first.emplace_back(i);
+        second.emplace_back(1000 + i);
+    }
+    relocatable_handle::moves = 0;
+    first.splice(first.begin() + 7, std::move(second));
+    EXPECT_TRUE(second.empty());
+    handle_vector moved(std::move(first), second_alloc);
+    EXPECT_TRUE(first.empty());
+    first.append(std::move(moved));
+    EXPECT_EQ(relocatable_handle::moves, 0);
+    ASSERT_EQ(first.size(), 2000);
+    EXPECT_EQ(*first[6].value, 6);
+    EXPECT_EQ(*first[7].value, 1000);
+    EXPECT_EQ(*first[1007].value, 7);
+    EXPECT_EQ(*first.back().value, 999);
+}
+}  // namespace
+
+// Bulk append testing
+namespace {
+TEST(BulkAppendTest, append_uninitialized_runs_per_chunk) {
+    vector<int> v(1000, 7);
+    std::vector<std::size_t> runs;
+    int next = 1000;
+    v.append_uninitialized(3000, [&](int *data, std::size_t n) {
+        runs.push_back(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            new (data + i) int(next++);
+        }
+    });
+    EXPECT_EQ(runs, (std::vector<std::size_t>{24, 1024, 1024, 928}));
+    ASSERT_EQ(v.size(), 4000);
+    EXPECT_EQ(v[999], 7);
+    for (int i = 1000; i < 4000; ++i) {
+        ASSERT_EQ(v[i], i);
+    }
+}
+
+TEST(BulkAppendTest, grow_by_returns_writable_spans) {
+    vector<test_int> v;
+    v.push_back(-1);
+    const auto spans = v.grow_by(1500);
+    EXPECT_EQ(spans.size(), 1500);
+    EXPECT_EQ(v.size(), 1501);
+    int next = 0;
+    std::size_t span_count = 0;
+    for (const auto &span : spans) {
+        ++span_count;
+        for (test_int &value : span) {
+            value = next++;
+        }
+    }
+    EXPECT_EQ(span_count, 2);
+    EXPECT_EQ(next, 1500);
+    EXPECT_EQ(v[0].m_value, -1);
+    EXPECT_EQ(v[1].m_value, 0);
+    EXPECT_EQ(v[1500].m_value, 1499);
+    EXPECT_EQ(v.grow_by(0).begin(), v.grow_by(0).end());
+}
+
+TEST(BulkAppendTest, append_range) {
+    std::list<std::string> words = {"one", "two", "three"};
+    vector<std::string> v = {"zero"};
+    v.append_range(words.begin(), words.end());
+    ASSERT_EQ(v.size(), 4);
+    EXPECT_EQ(v[3], "three");
+
+    std::vector<int> values(5000);
+    std::iota(values.begin(), values.end(), 0);
+    vector<int> numbers;
+    numbers.append_range(values.begin(), values.begin() + 10);
+    numbers.append_range(values.begin() + 10, values.end());
+    ASSERT_EQ(numbers.size(), 5000);
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(numbers[i], i);
+    }
+}
+}  // namespace
+
+// Stream ingestion testing
+namespace {
+TEST(StreamIngestTest, assign_from_istream_iterator) {
+    std::stringstream text;
+    for (int i = 0; i < 3000; ++i) {
+        text << i << ' ';
+    }
+    vector<int> v(5, -1);
+    v.assign(std::istream_iterator<int>(text), std::istream_iterator<int>());
+    ASSERT_EQ(v.size(), 3000);
+    for (int i = 0; i < 3000; ++i) {
+        ASSERT_EQ(v[i], i);
+    }
+
+    std::stringstream shorter("7 8");
+    v.assign(
+        std::istream_iterator<int>(shorter), std::istream_iterator<int>()
+    );
+    ASSERT_EQ(v.size(), 2);
+    EXPECT_EQ(v[0], 7);
+    EXPECT_EQ(v[1], 8);
+}
+
+TEST(StreamIngestTest, insert_single_pass_range) {
+    vector<test_int> v;
+    for (int i = 0; i < 10; ++i) {
+        v.push_back(i);
+    }
+    std::stringstream text("100 101 102");
+    auto it = v.insert(
+        v.begin() + 3, std::istream_iterator<int>(text),
+        std::istream_iterator<int>()
+    );
+    EXPECT_EQ(it - v.begin(), 3);
+    ASSERT_EQ(v.size(), 13);
+    EXPECT_EQ(v[2].m_value, 2);
+    EXPECT_EQ(v[3].m_value, 100);
+    EXPECT_EQ(v[5].m_value, 102);
+    EXPECT_EQ(v[6].m_value, 3);
+    EXPECT_EQ(v[12].m_value, 9);
+
+    std::list<int> values(2000, 5);
+    v.insert(v.begin(), values.begin(), values.end());
+    ASSERT_EQ(v.size(), 2013);
+    EXPECT_EQ(v[1999].m_value, 5);
+    EXPECT_EQ(v[2000].m_value, 0);
+}
+
+TEST(StreamIngestTest, read_from) {
+    std::stringstream bytes;
+    for (int i = 0; i < 2500; ++i) {
+        bytes.write(reinterpret_cast<const char *>(&i), sizeof(i));
+    }
+    bytes.write("xy", 2);
+
+    vector<int> v = {-1};
+    EXPECT_EQ(v.read_from(bytes, 1000), 1000);
+    EXPECT_EQ(v.read_from(bytes, 5000), 1500);
+    EXPECT_TRUE(bytes.eof());
+    ASSERT_EQ(v.size(), 2501);
+    EXPECT_EQ(v[0], -1);
+    for (int i = 0; i < 2500; ++i) {
+        ASSERT_EQ(v[i + 1], i);
+    }
+    EXPECT_EQ(v.read_from(bytes, 10), 0);
+    EXPECT_EQ(v.size(), 2501);
+}
+}  // namespace
+
+// Structure-of-arrays testing
+namespace {
+using soa_record = std::tuple<int, double, std::string>;
+
+TEST(ChunkSoaVectorTest, records_through_references) {
+    CustomVector::chunk_soa_vector<soa_record, 4> v;
+    v.emplace_back(1, 1.5, "one");
+    v.push_back(soa_record(2, 2.5, "two"));
+    soa_record three(3, 3.5, "three");
+    v.push_back(three);
+    ASSERT_EQ(v.size(), 3);
+
+    auto [id, price, name] = v[1];
+    EXPECT_EQ(id, 2);
+    EXPECT_EQ(price, 2.5);
+    EXPECT_EQ(name, "two");
+    id = 20;
+    v[2] = soa_record(30, 30.5, "thirty");
+    EXPECT_EQ(v.field<0>(1), 20);
+    EXPECT_EQ(soa_record(v.back()), soa_record(30, 30.5, "thirty"));
+    EXPECT_EQ(std::get<2>(v.front()), "one");
+    EXPECT_THROW(v.at(3), std::out_of_range);
+
+    std::vector<int> ids;
+    for (auto record : v) {
+        ids.push_back(std::get<0>(record));
+    }
+    EXPECT_EQ(ids, (std::vector<int>{1, 20, 30}));
+    v.pop_back();
+    EXPECT_EQ(v.size(), 2);
+    EXPECT_EQ(v.column<2>().size(), 2);
+}
+
+TEST(ChunkSoaVectorTest, columns_are_chunk_aligned) {
+    CustomVector::chunk_soa_vector<std::tuple<int, double>, 1024> v;
+    for (int i = 0; i < 3000; ++i) {
+        v.emplace_back(i, i * 0.5);
+    }
+    EXPECT_EQ(v.chunk_count(), 3);
+    EXPECT_EQ(v.column<0>().chunk_count(), 3);
+    EXPECT_EQ(v.column<1>().chunk_count(), 3);
+    EXPECT_EQ(v.chunk_length(2), 952);
+    for (std::size_t c = 0; c < v.chunk_count(); ++c) {
+        const int *ids = v.chunk_data<0>(c);
+        double *halves = v.chunk_data<1>(c);
+        for (std::size_t i = 0; i < v.chunk_length(c); ++i) {
+            ASSERT_EQ(halves[i], ids[i] * 0.5);
+            halves[i] = ids[i];
+        }
+    }
+    EXPECT_EQ(CustomVector::sum(v.column<0>()), 2999LL * 3000 / 2);
+    EXPECT_EQ(v.field<1>(2999), 2999.0);
+}
+
+TEST(ChunkSoaVectorTest, resize_and_swap) {
+    CustomVector::chunk_soa_vector<soa_record> v(5);
+    EXPECT_EQ(v.size(), 5);
+    EXPECT_EQ(soa_record(v[4]), soa_record());
+    v.resize(2);
+    EXPECT_EQ(v.column<1>().size(), 2);
+    v.reserve(100);
+    EXPECT_GE(v.capacity(), 100);
+
+    CustomVector::chunk_soa_vector<soa_record> other = {
+        {7, 7.5, "seven"}, {8, 8.5, "eight"}, {9, 9.5, "nine"}};
+    swap(v, other);
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_EQ(other.size(), 2);
+    EXPECT_EQ(std::get<2>(v[2]), "nine");
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(ChunkSoaVectorTest, bool_fields) {
+    CustomVector::chunk_soa_vector<std::tuple<int, bool>> v;
+    for (int i = 0; i < 3000; ++i) {
+        v.emplace_back(i, i % 3 == 0);
+    }
+    auto [id, flag] = v[3];
+    EXPECT_EQ(id, 3);
+    EXPECT_TRUE(flag);
+    flag = false;
+    EXPECT_FALSE(v.field<1>(3));
+    v.field<1>(4) = true;
+    bool *flags = v.chunk_data<1>(0);
+    EXPECT_TRUE(flags[4]);
+    EXPECT_EQ(
+        std::count(v.column<1>().begin(), v.column<1>().end(), true), 1000
+    );
+}
+}  // namespace
+
+// Compressed chunks testing
+namespace {
+template <typename T, typename Generator>
+void check_codec(CustomVector::chunk_codec codec, Generator generate) {
+    CustomVector::compressed_chunk_vector<T, 256> v;
+    std::vector<T> expected;
+    for (std::size_t i = 0; i < 300; ++i) {
+        expected.push_back(generate(i));
+        v.push_back(expected.back());
+    }
+    v.seal();
+    ASSERT_EQ(v.sealed_chunk_count(), 1);
+    EXPECT_EQ(v.sealed_chunk_codec(0), codec);
+    ASSERT_EQ(v.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(v[i], expected[i]);
+    }
+}
+
+TEST(CompressedChunkVectorTest, codecs_round_trip) {
+    using CustomVector::chunk_codec;
+    check_codec<std::int64_t>(chunk_codec::delta_varint, [](std::size_t i) {
+        return std::int64_t(1'700'000'000'000) + 1000 * i + i % 7;
+    });
+    check_codec<std::int64_t>(chunk_codec::delta_varint, [](std::size_t i) {
+        return -std::int64_t(i * i);
+    });
+    check_codec<int>(chunk_codec::frame_of_reference, [](std::size_t i) {
+        return -1000 + static_cast<int>(i * 7919 % 600);
+    });
+    check_codec<std::uint64_t>(
+        chunk_codec::frame_of_reference,
+        [](std::size_t i) {
+            return std::numeric_limits<std::uint64_t>::max() - i * 7919 % 5000;
+        }
+    );
+    check_codec<std::int16_t>(chunk_codec::run_length, [](std::size_t i) {
+        return static_cast<std::int16_t>(i < 100 ? -5 : 32767);
+    });
+    check_codec<std::int64_t>(chunk_codec::raw, [](std::size_t i) {
+        return static_cast<std::int64_t>((i + 1) * 0x9e3779b97f4a7c15ULL);
+    });
+}
+
+TEST(CompressedChunkVectorTest, auto_seal_keeps_hot_tail) {
+    CustomVector::compressed_chunk_vector<std::int64_t, 512> v;
+    v.set_auto_seal(1);
+    for (std::int64_t i = 0; i < 5000; ++i) {
+        v.push_back(i * 10);
+    }
+    EXPECT_EQ(v.size(), 5000);
+    EXPECT_EQ(v.sealed_chunk_count(), 8);
+    EXPECT_LT(v.memory_usage(), 5000 * sizeof(std::int64_t) / 2);
+    for (std::int64_t i = 4999; i >= 0; i -= 7) {
+        ASSERT_EQ(v[i], i * 10);
+    }
+
+    long long total = 0;
+    std::size_t chunks = 0;
+    v.for_each_chunk([&](const std::int64_t *data, std::size_t n) {
+        ++chunks;
+        total += std::accumulate(data, data + n, 0LL);
+    });
+    EXPECT_EQ(chunks, 10);
+    EXPECT_EQ(total, 10LL * 4999 * 5000 / 2);
+    EXPECT_THROW(static_cast<void>(v.at(5000)), std::out_of_range);
+}
+
+TEST(CompressedChunkVectorTest, set_and_pop_back_across_sealed_chunks) {
+    CustomVector::compressed_chunk_vector<int, 128> v;
+    for (int i = 0; i < 300; ++i) {
+        v.push_back(i);
+    }
+    v.seal();
+    EXPECT_EQ(v[5], 5);
+    v.set(5, -5);
+    v.set(299, -299);
+    EXPECT_EQ(v[5], -5);
+    EXPECT_EQ(v[6], 6);
+    EXPECT_EQ(v.back(), -299);
+
+    while (v.size() > 200) {
+        v.pop_back();
+    }
+    EXPECT_EQ(v.sealed_chunk_count(), 1);
+    EXPECT_EQ(v.back(), 199);
+    std::vector<int> values(v.begin(), v.end());
+    ASSERT_EQ(values.size(), 200);
+    EXPECT_EQ(values[5], -5);
+    EXPECT_EQ(values[150], 150);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+}  // namespace
+
+// Sparse vector testing
+namespace {
+TEST(SparseChunkVectorTest, huge_resize_allocates_touched_chunks_only) {
+    CustomVector::sparse_chunk_vector<int> v(1'000'000'000);
+    EXPECT_EQ(v.size(), 1'000'000'000);
+    EXPECT_EQ(v.materialized_chunk_count(), 0);
+    EXPECT_LT(v.memory_usage(), 8'000'000);
+    EXPECT_EQ(v[999'999'999], 0);
+    EXPECT_EQ(v.back(), 0);
+
+    v.write(123'456'789) = 5;
+    v.write(123'456'790) = 6;
+    EXPECT_EQ(v.materialized_chunk_count(), 1);
+    EXPECT_EQ(v[123'456'789], 5);
+    EXPECT_EQ(v[123'456'790], 6);
+    EXPECT_EQ(v[123'456'788], 0);
+    EXPECT_TRUE(v.is_materialized(123'456'789 / 2048));
+    EXPECT_FALSE(v.is_materialized(0));
+    EXPECT_THROW(static_cast<void>(v.at(1'000'000'000)), std::out_of_range);
+}
+
+TEST(SparseChunkVectorTest, elements_of_allocated_chunks) {
+    CustomVector::sparse_chunk_vector<std::string, 4> v(6);
+    v.write(5) = "five";
+    EXPECT_EQ(v[4], "");
+    v.push_back("six");
+    v.push_back("seven");
+    v.push_back("eight");
+    EXPECT_EQ(v.size(), 9);
+    EXPECT_EQ(v.chunk_count(), 3);
+    EXPECT_EQ(v.materialized_chunk_count(), 2);
+
+    v.pop_back();
+    EXPECT_EQ(v.chunk_count(), 2);
+    v.resize(6);
+    v.resize(8);
+    EXPECT_EQ(v[5], "five");
+    EXPECT_EQ(v[6], "");
+    EXPECT_EQ(v[7], "");
+
+    CustomVector::sparse_chunk_vector<std::string, 4> copy(v);
+    v.write(0) = "zero";
+    EXPECT_EQ(copy[0], "");
+    EXPECT_EQ(copy[5], "five");
+    EXPECT_EQ(copy.materialized_chunk_count(), 1);
+    copy = v;
+    EXPECT_EQ(copy[0], "zero");
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(copy.size(), 8);
+}
+
+TEST(SparseChunkVectorTest, chunk_scans) {
+    CustomVector::sparse_chunk_vector<long long, 1024> v(10'000);
+    for (std::size_t i = 0; i < 10'000; i += 3000) {
+        v.write(i) = static_cast<long long>(i);
+    }
+    long long total = 0;
+    std::size_t chunks = 0;
+    v.for_each_chunk([&](const long long *data, std::size_t n) {
+        ++chunks;
+        total += std::accumulate(data, data + n, 0LL);
+    });
+    EXPECT_EQ(chunks, 10);
+    EXPECT_EQ(total, 18'000);
+
+    std::vector<std::size_t> written;
+    v.for_each_materialized_chunk(
+        [&](std::size_t chunk, long long *data, std::size_t n) {
+            written.push_back(chunk);
+            std::fill(data, data + n, 1);
+        }
+    );
+    EXPECT_EQ(written, (std::vector<std::size_t>{0, 2, 5, 8}));
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0LL), 4 * 1024);
+}
+}  // namespace
+
+// Packed bool vector testing
+namespace {
+using bit_vector = CustomVector::chunk_vector<bool, 256>;
+
+TEST(ChunkVectorBoolTest, proxy_references) {
+    bit_vector v{true, false, true};
+    EXPECT_EQ(v.size(), 3);
+    EXPECT_TRUE(v[0]);
+    EXPECT_FALSE(v[1]);
+    v[1] = v[0];
+    v[0].flip();
+    EXPECT_FALSE(v.front());
+    EXPECT_TRUE(v.at(1));
+    swap(v[0], v[2]);
+    EXPECT_TRUE(v[0]);
+    EXPECT_FALSE(v.back());
+    EXPECT_THROW(static_cast<void>(v.at(3)), std::out_of_range);
+
+    for (int i = 0; i < 1000; ++i) {
+        v.push_back(i % 7 == 0);
+    }
+    EXPECT_EQ(v.chunk_count(), 4);
+    EXPECT_EQ(std::count(v.begin(), v.end(), true), v.count());
+    std::sort(v.begin(), v.end());
+    EXPECT_TRUE(std::is_sorted(v.begin(), v.end()));
+    EXPECT_EQ(v.find_first(), v.size() - v.count());
+
+    const bit_vector copy(v);
+    EXPECT_EQ(copy, v);
+    v.resize(10);
+    v.resize(1003);
+    EXPECT_EQ(v.count(), 0);
+    EXPECT_NE(copy, v);
+    v.pop_back();
+    EXPECT_EQ(v.size(), 1002);
+}
+
+TEST(ChunkVectorBoolTest, find_and_fill) {
+    bit_vector v(1000);
+    EXPECT_EQ(v.find_first(), bit_vector::npos);
+    v.fill(100, 700, true);
+    EXPECT_EQ(v.count(), 600);
+    v.fill(200, 201, false);
+    EXPECT_EQ(v.find_first(), 100);
+    EXPECT_EQ(v.find_next(199), 201);
+    EXPECT_EQ(v.find_next(699), bit_vector::npos);
+    v[999] = true;
+    EXPECT_EQ(v.find_next(699), 999);
+    EXPECT_EQ(v.find_next(999), bit_vector::npos);
+
+    std::size_t found = 0;
+    for (auto i = v.find_first(); i != bit_vector::npos; i = v.find_next(i)) {
+        EXPECT_TRUE(v[i]);
+        ++found;
+    }
+    EXPECT_EQ(found, 600);
+
+    v.flip();
+    EXPECT_EQ(v.count(), 400);
+    v.resize(1010, true);
+    EXPECT_EQ(v.count(), 410);
+    v.fill(false);
+    EXPECT_EQ(v.count(), 0);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(ChunkVectorBoolTest, bitwise_operations_on_every_level) {
+    using level = CustomVector::simd::level;
+    std::vector<bool> expected_a(3001), expected_b(3001);
+    bit_vector a(3001), b(3001);
+    for (std::size_t i = 0; i < 3001; ++i) {
+        expected_a[i] = a[i] = i % 3 == 0;
+        expected_b[i] = b[i] = i % 5 == 0;
+    }
+    for (level l : {level::scalar, level::sse2, level::avx2}) {
+        CustomVector::simd::set_level(l);
+        const bit_vector both = a & b, either = a | b, one = a ^ b;
+        for (std::size_t i = 0; i < 3001; ++i) {
+            EXPECT_EQ(both[i], expected_a[i] && expected_b[i]);
+            EXPECT_EQ(either[i], expected_a[i] || expected_b[i]);
+            EXPECT_EQ(one[i], expected_a[i] != expected_b[i]);
+        }
+        EXPECT_EQ(both.count(), 201);
+        EXPECT_EQ(either.count(), 1401);
+        EXPECT_EQ(one.count(), 1200);
+        EXPECT_EQ(bit_vector(3001, true).count(), 3001);
+    }
+    CustomVector::simd::set_level(level::avx2);
+    EXPECT_THROW(a &= bit_vector(3000), std::invalid_argument);
+}
+
+TEST(ChunkVectorBoolTest, insert_and_erase_match_std_vector_bool) {
+    std::vector<bool> expected;
+    bit_vector v;
+    for (std::size_t i = 0; i < 700; ++i) {
+        expected.push_back(i % 3 == 0);
+        v.push_back(i % 3 == 0);
+    }
+    const auto same = [&] {
+        ASSERT_EQ(v.size(), expected.size());
+        EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+        EXPECT_EQ(
+            v.count(),
+            static_cast<std::size_t>(
+                std::count(expected.begin(), expected.end(), true)
+            )
+        );
+    };
+    EXPECT_EQ(v.insert(v.begin() + 5, true) - v.begin(), 5);
+    expected.insert(expected.begin() + 5, true);
+    same();
+    v.insert(v.begin() + 63, 300, true);
+    expected.insert(expected.begin() + 63, 300, true);
+    same();
+    const std::vector<bool> range = {true, true, false, true, false};
+    v.insert(v.begin() + 255, range.begin(), range.end());
+    expected.insert(expected.begin() + 255, range.begin(), range.end());
+    same();
+    std::istringstream stream("1 0 1 1");
+    v.insert(
+        v.begin() + 1, std::istream_iterator<int>(stream),
+        std::istream_iterator<int>()
+    );
+    expected.insert(expected.begin() + 1, {true, false, true, true});
+    same();
+    v.emplace(v.end(), true);
+    expected.push_back(true);
+    same();
+    EXPECT_EQ(v.erase(v.begin() + 100, v.begin() + 613) - v.begin(), 100);
+    expected.erase(expected.begin() + 100, expected.begin() + 613);
+    same();
+    v.erase(v.begin());
+    expected.erase(expected.begin());
+    same();
+    v.erase(v.begin() + 10, v.end());
+    expected.resize(10);
+    same();
+    v.resize(1000);
+    expected.resize(1000);
+    same();
+
+    v.assign(300, true);
+    EXPECT_EQ(v.count(), 300);
+    v.assign({false, true});
+    EXPECT_EQ(v, (bit_vector{false, true}));
+}
+
+TEST(ChunkVectorBoolTest, lexicographical_compare) {
+    bit_vector a(300), b(300);
+    EXPECT_EQ(compare(a, b), 0);
+    b[299] = true;
+    EXPECT_LT(a, b);
+    a[100] = true;
+    EXPECT_GT(a, b);
+    EXPECT_GE(a, b);
+    EXPECT_LE(b, a);
+    EXPECT_LT(bit_vector(64, true), bit_vector(65, true));
+    EXPECT_LT(bit_vector(65, false), bit_vector(64, true));
+    EXPECT_EQ(compare(bit_vector{}, bit_vector(1)), -1);
+}
+
+TEST(ChunkVectorBoolTest, unpackable_shapes_stay_generic) {
+    CustomVector::chunk_vector<bool, 100> v(150, true);
+    v.erase(v.begin() + 10, v.begin() + 20);
+    v.insert(v.begin(), false);
+    EXPECT_EQ(v.size(), 141);
+    EXPECT_FALSE(v[0]);
+    EXPECT_EQ(*v.chunk_data(1), true);
+    CustomVector::chunk_vector<bool, 128, std::allocator<bool>, 4> adaptive;
+    adaptive.push_back(true);
+    EXPECT_TRUE(adaptive.front());
+}
+}  // namespace
+
+// Zone map testing
+namespace {
+using zoned_vector = CustomVector::zoned_chunk_vector<int, 4>;
+
+template <class Vector>
+std::size_t count_in_range(const Vector &v, int low, int high) {
+    return static_cast<std::size_t>(
+        std::count_if(v.begin(), v.end(), [low, high](int x) {
+            return low <= x && x <= high;
+        })
+    );
+}
+
+TEST(ZonedChunkVectorTest, zones_follow_push_back_and_pop_back) {
+    zoned_vector v;
+    for (int i = 0; i < 10; ++i) {
+        v.push_back(i % 2 == 0 ? i : -i);
+    }
+    EXPECT_EQ(v.chunk_count(), 3);
+    EXPECT_EQ(v.chunk_bounds(0), std::make_pair(-3, 2));
+    EXPECT_EQ(v.chunk_bounds(1), std::make_pair(-7, 6));
+    EXPECT_EQ(v.chunk_bounds(2), std::make_pair(-9, 8));
+
+    v.emplace_back(100);
+    EXPECT_EQ(v.chunk_bounds(2), std::make_pair(-9, 100));
+    v.pop_back();
+    EXPECT_EQ(v.chunk_bounds(2), std::make_pair(-9, 8));
+    v.pop_back();
+    v.pop_back();
+    EXPECT_EQ(v.chunk_count(), 2);
+    v.pop_back();
+    EXPECT_EQ(v.chunk_bounds(1), std::make_pair(-5, 6));
+}
+
+TEST(ZonedChunkVectorTest, writes_dirty_zones) {
+    zoned_vector v{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(v.chunk_bounds(1), std::make_pair(5, 8));
+    v[6] = 50;
+    EXPECT_EQ(v.chunk_bounds(1), std::make_pair(5, 50));
+    v.chunk_data(0)[0] = -1;
+    EXPECT_EQ(v.chunk_bounds(0), std::make_pair(-1, 4));
+
+    v.erase(v.begin());
+    EXPECT_EQ(v.chunk_bounds(0), std::make_pair(2, 5));
+    EXPECT_EQ(v.chunk_bounds(1), std::make_pair(6, 50));
+    EXPECT_EQ(v.chunk_count(), 2);
+    v.insert(v.begin() + 1, 40);
+    EXPECT_EQ(v.chunk_bounds(0), std::make_pair(2, 40));
+    EXPECT_EQ(v.chunk_bounds(2), std::make_pair(9, 9));
+    v.resize(3);
+    EXPECT_EQ(v.chunk_bounds(0), std::make_pair(2, 40));
+    v.resize(6, -7);
+    EXPECT_EQ(v.chunk_bounds(0), std::make_pair(-7, 40));
+    EXPECT_EQ(v.chunk_bounds(1), std::make_pair(-7, -7));
+}
+
+TEST(ZonedChunkVectorTest, range_queries) {
+    CustomVector::zoned_chunk_vector<int, 64> v;
+    EXPECT_EQ(v.find_in_range(0, 10), v.npos);
+    for (int i = 0; i < 10'000; ++i) {
+        v.push_back(i + i * 37 % 100);
+    }
+    const std::vector<std::pair<int, int>> ranges = {
+        {0, 10'200}, {500, 600}, {-5, -1}, {9000, 9000}
+    };
+    for (auto [low, high] : ranges) {
+        EXPECT_EQ(v.count_in_range(low, high), count_in_range(v, low, high));
+    }
+
+    const auto &values = v.values();
+    const std::size_t first = v.find_in_range(5000, 5010);
+    ASSERT_NE(first, v.npos);
+    EXPECT_EQ(first, std::find_if(values.begin(), values.end(), [](int x) {
+                         return 5000 <= x && x <= 5010;
+                     }) - values.begin());
+    const std::size_t next = v.find_in_range(5000, 5010, first + 1);
+    EXPECT_GT(next, first);
+    EXPECT_TRUE(5000 <= values[next] && values[next] <= 5010);
+    EXPECT_EQ(v.find_in_range(20'000, 30'000), v.npos);
+}
+
+// Allocator that throws std::bad_alloc once *budget allocations are made.
+template <typename T>
+struct BudgetAlloc {
+    using value_type = T;
+    std::size_t *budget;
+
+    explicit BudgetAlloc(std::size_t *budget) : budget(budget) {
+    }
+
+    T *allocate(std::size_t n) {
+        if (*budget == 0) {
+            throw std::bad_alloc();
+        }
+        --*budget;
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, std::size_t) {
+        ::operator delete(ptr);
+    }
+
+    bool operator==(const BudgetAlloc &other) const {
+        return budget == other.budget;
+    }
+
+    bool operator!=(const BudgetAlloc &other) const {
+        return budget != other.budget;
+    }
+};
+
+TEST(ZonedChunkVectorTest, zones_fit_the_chunks_after_a_failed_write) {
+    std::size_t budget = 2;
+    CustomVector::zoned_chunk_vector<int, 4, BudgetAlloc<int>> v(
+        (BudgetAlloc<int>(&budget))
+    );
+    for (int i = 0; i < 8; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_THROW(v.insert(v.cbegin(), 100), std::bad_alloc);
+    EXPECT_THROW(v.resize(12, 100), std::bad_alloc);
+    ASSERT_EQ(v.size(), 8);
+    v[7] = 100;
+    EXPECT_EQ(v.count_in_range(0, 6), 7);
+    EXPECT_EQ(v.find_in_range(100, 100), 7);
+    EXPECT_EQ(v.chunk_bounds(1), std::make_pair(4, 100));
+}
+
+TEST(ZonedChunkVectorTest, nans_are_in_no_range) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    CustomVector::zoned_chunk_vector<double, 4> pushed;
+    for (double x : {1.0, nan, 2.0, nan, nan}) {
+        pushed.push_back(x);
+    }
+    EXPECT_EQ(pushed.count_in_range(0, 5), 2);
+    EXPECT_EQ(pushed.chunk_bounds(0), std::make_pair(1.0, 2.0));
+    EXPECT_EQ(pushed.find_in_range(0, 5, 3), pushed.npos);
+    pushed.push_back(3.0);
+    EXPECT_EQ(pushed.find_in_range(0, 5, 3), 5);
+
+    CustomVector::zoned_chunk_vector<double, 4> constructed = {nan, 1, 2};
+    EXPECT_EQ(constructed.find_in_range(0, 5), 1);
+    EXPECT_EQ(constructed.count_in_range(0, 5), 2);
+    EXPECT_EQ(constructed.chunk_bounds(0), std::make_pair(1.0, 2.0));
+}
+}  // namespace
+
+// Sorted vector testing
+namespace {
+using sorted_vector = CustomVector::sorted_chunk_vector<int, 4>;
+
+std::vector<int> chunk_lengths(const sorted_vector &v) {
+    std::vector<int> lengths;
+    v.for_each_chunk([&](const int *, std::size_t n) {
+        lengths.push_back(static_cast<int>(n));
+    });
+    return lengths;
+}
+
+TEST(SortedChunkVectorTest, insert_splits_full_chunks) {
+    sorted_vector v{9, 1, 5, 3, 7, 11, 13, 15};
+    EXPECT_EQ(chunk_lengths(v), (std::vector<int>{4, 4}));
+    EXPECT_EQ(v.fence(1), 9);
+
+    EXPECT_EQ(*v.insert(4), 4);
+    EXPECT_EQ(chunk_lengths(v), (std::vector<int>{3, 2, 4}));
+    EXPECT_EQ(v.fence(1), 5);
+    v.insert(0);
+    EXPECT_EQ(v.fence(0), 0);
+    v.insert(17);
+    v.insert(19);
+    EXPECT_EQ(chunk_lengths(v), (std::vector<int>{4, 2, 4, 2}));
+    EXPECT_EQ(
+        std::vector<int>(v.begin(), v.end()),
+        (std::vector<int>{0, 1, 3, 4, 5, 7, 9, 11, 13, 15, 17, 19})
+    );
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        EXPECT_EQ(v[i], *(v.begin() + static_cast<std::ptrdiff_t>(i)));
+    }
+    EXPECT_EQ(v.at(11), 19);
+    EXPECT_THROW(static_cast<void>(v.at(12)), std::out_of_range);
+    EXPECT_EQ(v.rbegin()[1], 17);
+}
+
+TEST(SortedChunkVectorTest, lookups_with_duplicates) {
+    sorted_vector v;
+    for (int i = 0; i < 30; ++i) {
+        v.insert(i / 10 * 10);
+    }
+    EXPECT_EQ(v.chunk_count(), 8);
+    EXPECT_EQ(v.lower_bound(10) - v.begin(), 10);
+    EXPECT_EQ(v.upper_bound(10) - v.begin(), 20);
+    EXPECT_EQ(v.lower_bound(5) - v.begin(), 10);
+    EXPECT_EQ(v.upper_bound(-1), v.begin());
+    EXPECT_EQ(v.lower_bound(21), v.end());
+    EXPECT_EQ(v.count(20), 10);
+    EXPECT_TRUE(v.contains(0));
+    EXPECT_FALSE(v.contains(15));
+    EXPECT_EQ(v.find(15), v.end());
+    EXPECT_EQ(*v.find(20), 20);
+    auto [first, last] = v.equal_range(0);
+    EXPECT_EQ(first, v.begin());
+    EXPECT_EQ(last - first, 10);
+}
+
+TEST(SortedChunkVectorTest, erase_releases_empty_chunks) {
+    sorted_vector v{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(*v.erase(v.begin()), 2);
+    EXPECT_EQ(v.fence(0), 2);
+    EXPECT_EQ(v.erase(4), 1);
+    EXPECT_EQ(v.erase(4), 0);
+    const auto after_last = v.erase(v.find(9));
+    EXPECT_EQ(after_last, v.end());
+    EXPECT_EQ(v.chunk_count(), 2);
+    const auto after_range = v.erase(v.lower_bound(5), v.upper_bound(8));
+    EXPECT_EQ(after_range, v.end());
+    EXPECT_EQ(v.chunk_count(), 1);
+    EXPECT_EQ(std::vector<int>(v.begin(), v.end()), (std::vector<int>{2, 3}));
+
+    sorted_vector copy(v);
+    v.pop_back();
+    v.pop_back();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.chunk_count(), 0);
+    EXPECT_EQ(copy.size(), 2);
+    v = copy;
+    EXPECT_EQ(v, copy);
+}
+}  // namespace
+
+// Batched access testing
+namespace {
+class BatchedAccessTest : public ::testing::Test {
+protected:
+    vector<int> v;
+    std::vector<std::size_t> indices;
+
+    BatchedAccessTest() {
+        for (int i = 0; i < 10'000; ++i) {
+            v.push_back(3 * i);
+        }
+        for (std::size_t i = 0; i < 5'000; ++i) {
+            indices.push_back(i * 7919 % 10'000);
+        }
+    }
+};
+
+TEST_F(BatchedAccessTest, gather) {
+    std::vector<int> out;
+    v.gather(indices.begin(), indices.end(), std::back_inserter(out));
+    ASSERT_EQ(out.size(), indices.size());
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+        EXPECT_EQ(out[k], v[indices[k]]);
+    }
+
+    const std::list<std::size_t> few = {9'999, 0, 1'024, 0};
+    int values[4];
+    EXPECT_EQ(v.gather(few.begin(), few.end(), values), values + 4);
+    EXPECT_EQ(
+        std::vector<int>(values, values + 4),
+        (std::vector<int>{29'997, 0, 3'072, 0})
+    );
+}
+
+TEST_F(BatchedAccessTest, gather_sorted_indices) {
+    std::sort(indices.begin(), indices.end());
+    indices.insert(indices.begin() + 100, indices[100]);
+    std::vector<int> out(indices.size());
+    const auto end = v.gather(
+        CustomVector::sorted_indices, indices.begin(), indices.end(),
+        out.begin()
+    );
+    EXPECT_EQ(end, out.end());
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+        EXPECT_EQ(out[k], v[indices[k]]);
+    }
+    EXPECT_EQ(out[100], out[101]);
+}
+
+TEST_F(BatchedAccessTest, int_indices) {
+    const std::vector<int> sorted = {0, 5, 5, 2'048, 9'999};
+    std::vector<int> out;
+    v.gather(
+        CustomVector::sorted_indices, sorted.begin(), sorted.end(),
+        std::back_inserter(out)
+    );
+    EXPECT_EQ(out, (std::vector<int>{0, 15, 15, 6'144, 29'997}));
+    out.clear();
+    v.gather(sorted.rbegin(), sorted.rend(), std::back_inserter(out));
+    EXPECT_EQ(out, (std::vector<int>{29'997, 6'144, 15, 15, 0}));
+
+    const int values[] = {1, 2, 3, 4, 5};
+    v.scatter(
+        CustomVector::sorted_indices, sorted.begin(), sorted.end(), values
+    );
+    EXPECT_EQ(v[5], 3);
+    v.scatter(sorted.begin(), sorted.end(), values);
+    EXPECT_EQ(v[9'999], 5);
+}
+
+TEST_F(BatchedAccessTest, scatter) {
+    std::vector<int> values(indices.size());
+    std::iota(values.begin(), values.end(), -5'000);
+    EXPECT_EQ(
+        v.scatter(indices.begin(), indices.end(), values.begin()),
+        values.end()
+    );
+    for (std::size_t k = 0; k < indices.size(); ++k) {
+        EXPECT_EQ(v[indices[k]], values[k]);
+    }
+    EXPECT_EQ(v[1], 3);
+
+    const std::vector<std::size_t> sorted = {0, 5, 5, 2'048, 9'999};
+    const int sorted_values[] = {1, 2, 3, 4, 5};
+    v.scatter(
+        CustomVector::sorted_indices, sorted.begin(), sorted.end(),
+        sorted_values
+    );
+    EXPECT_EQ(v[0], 1);
+    EXPECT_EQ(v[5], 3);
+    EXPECT_EQ(v[2'048], 4);
+    EXPECT_EQ(v[9'999], 5);
+}
+}  // namespace
+
 // TODO tests for incomplete types
 
 int main(int argc, char **argv) {
@@ -0,0 +1,440 @@
+#ifndef ZONED_CHUNK_VECTOR_HPP
+#define ZONED_CHUNK_VECTOR_HPP
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "chunk_algorithms.hpp"
+#include "chunk_vector.hpp"
+
+namespace CustomVector {
+// chunk_vector of numbers with a zone map: the minimum and maximum of every
+// chunk. find_in_range and count_in_range skip the chunks whose zone lies
+// outside [low, high] and count the ones inside it without reading them, so
+// selective range predicates touch few chunks.
+//
+// push_back and emplace_back widen the zone of the last chunk. Non-const
+// operator[], at(), front(), back() and chunk_data() mark the chunk dirty,
+// and insert, erase and resize mark every chunk from the position on; a
+// dirty zone is recomputed by the next query that needs it.
+// Queries thus update the zones even through const access, so a vector
+// must not be queried from several threads at once. NaNs are in no range:
+// zones bound the other elements and note that the chunk holds a NaN.
+//
+//     zoned_chunk_vector<int> prices;
+//     ...
+//     std::size_t cheap = prices.count_in_range(10, 20);
+template <
+    typename T,
+    std::size_t chunk_size = (sizeof(T) > 8192 ? 1 : 8192 / sizeof(T)),
+    typename Alloc = std::allocator<T>>
+class zoned_chunk_vector {
+    static_assert(
+        std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+        "zoned_chunk_vector holds numbers"
+    );
+
+public:
+    using values_type = chunk_vector<T, chunk_size, Alloc>;
+
+    // Member types
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using const_iterator = typename values_type::const_iterator;
+
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+private:
+    struct zone {
+        T min;
+        T max;
+        bool dirty;
+        // Some element is a NaN, so the chunk is never counted whole.
+        bool has_nan;
+    };
+
+    values_type v_values;
+    mutable std::vector<zone> v_zones;
+
+    void check_out_of_bound(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range(
+                "Requested index: " + std::to_string(index) +
+                ", size: " + std::to_string(size())
+            );
+        }
+    }
+
+    // The zone of chunk, recomputed first if it is dirty.
+    const zone &zone_of(size_type chunk) const {
+        zone &result = v_zones[chunk];
+        if (result.dirty) {
+            const T *data = v_values.chunk_data(chunk);
+            const size_type n = v_values.chunk_length(chunk);
+            result.min = simd::min(data, n, data[0]);
+            result.max = simd::max(data, n, data[0]);
+            result.has_nan = false;
+            if constexpr (std::is_floating_point_v<T>) {
+                if (std::any_of(data, data + n, is_nan)) {
+                    bound_numbers(result, data, n);
+                }
+            }
+            result.dirty = false;
+        }
+        return result;
+    }
+
+    // Bounds of the elements of data other than NaNs; they stay NaN if all
+    // elements are.
+    static void bound_numbers(zone &result, const T *data, size_type n) {
+        result.has_nan = true;
+        result.min = result.max = std::numeric_limits<T>::quiet_NaN();
+        for (size_type i = 0; i < n; ++i) {
+            if (is_nan(data[i])) {
+                continue;
+            }
+            if (is_nan(result.min) || data[i] < result.min) {
+                result.min = data[i];
+            }
+            if (is_nan(result.max) || result.max < data[i]) {
+                result.max = data[i];
+            }
+        }
+    }
+
+    // Fits the zones to the chunks and marks the ones from pos on dirty.
+    void dirty_from(size_type pos) {
+        v_zones.resize(v_values.chunk_count());
+        for (size_type i = pos / chunk_size; i < v_zones.size(); ++i) {
+            v_zones[i].dirty = true;
+        }
+    }
+
+    // Accounts for the element just appended.
+    void widen_back() {
+        const T &value = v_values.back();
+        if (v_zones.size() < v_values.chunk_count()) {
+            v_zones.push_back(zone{value, value, false, is_nan(value)});
+            return;
+        }
+        zone &last = v_zones.back();
+        if (is_nan(value)) {
+            last.has_nan = true;
+        } else if (is_nan(last.min)) {
+            last.min = last.max = value;
+        } else if (!last.dirty) {
+            last.min = std::min(last.min, value);
+            last.max = std::max(last.max, value);
+        }
+    }
+
+    [[nodiscard]] static bool is_nan(const T &value) noexcept {
+        return value != value;
+    }
+
+    [[nodiscard]] static bool
+    in_range(const T &value, const T &low, const T &high) noexcept {
+        return low <= value && value <= high;
+    }
+
+public:
+    zoned_chunk_vector() = default;
+
+    explicit zoned_chunk_vector(const allocator_type &alloc)
+        : v_values(alloc) {
+    }
+
+    zoned_chunk_vector(
+        size_type count,
+        const T &value,
+        const allocator_type &alloc = allocator_type()
+    )
+        : v_values(count, value, alloc) {
+        dirty_from(0);
+    }
+
+    zoned_chunk_vector(
+        std::initializer_list<value_type> init,
+        const allocator_type &alloc = allocator_type()
+    )
+        : v_values(init, alloc) {
+        dirty_from(0);
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return v_values.get_allocator();
+    }
+
+    // Element access
+    // Non-const access marks the chunk of the element dirty.
+    reference operator[](size_type pos) noexcept {
+        v_zones[pos / chunk_size].dirty = true;
+        return v_values[pos];
+    }
+
+    const_reference operator[](size_type pos) const noexcept {
+        return v_values[pos];
+    }
+
+    reference at(size_type pos) {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    [[nodiscard]] const_reference at(size_type pos) const {
+        check_out_of_bound(pos);
+        return (*this)[pos];
+    }
+
+    reference front() noexcept {
+        return (*this)[0];
+    }
+
+    [[nodiscard]] const_reference front() const noexcept {
+        return (*this)[0];
+    }
+
+    reference back() noexcept {
+        return (*this)[size() - 1];
+    }
+
+    [[nodiscard]] const_reference back() const noexcept {
+        return (*this)[size() - 1];
+    }
+
+    // The elements without their zones, for the algorithms of
+    // chunk_algorithms.hpp.
+    [[nodiscard]] const values_type &values() const noexcept {
+        return v_values;
+    }
+
+    // Chunk access
+    [[nodiscard]] size_type chunk_count() const noexcept {
+        return v_values.chunk_count();
+    }
+
+    T *chunk_data(size_type chunk) noexcept {
+        v_zones[chunk].dirty = true;
+        return v_values.chunk_data(chunk);
+    }
+
+    [[nodiscard]] const T *chunk_data(size_type chunk) const noexcept {
+        return v_values.chunk_data(chunk);
+    }
+
+    [[nodiscard]] size_type chunk_length(size_type chunk) const noexcept {
+        return v_values.chunk_length(chunk);
+    }
+
+    // The minimum and maximum of the elements of chunk.
+    [[nodiscard]] std::pair<T, T> chunk_bounds(size_type chunk) const {
+        const zone &bounds = zone_of(chunk);
+        return {bounds.min, bounds.max};
+    }
+
+    // Iterators
+    [[nodiscard]] const_iterator begin() const noexcept {
+        return v_values.begin();
+    }
+
+    [[nodiscard]] const_iterator cbegin() const noexcept {
+        return v_values.cbegin();
+    }
+
+    [[nodiscard]] const_iterator end() const noexcept {
+        return v_values.end();
+    }
+
+    [[nodiscard]] const_iterator cend() const noexcept {
+        return v_values.cend();
+    }
+
+    // Capacity
+    [[nodiscard]] bool empty() const noexcept {
+        return v_values.empty();
+    }
+
+    [[nodiscard]] size_type size() const noexcept {
+        return v_values.size();
+    }
+
+    [[nodiscard]] size_type max_size() const noexcept {
+        return v_values.max_size();
+    }
+
+    void reserve(size_type count) {
+        v_values.reserve(count);
+        v_zones.reserve((count + chunk_size - 1) / chunk_size);
+    }
+
+    [[nodiscard]] size_type capacity() const noexcept {
+        return v_values.capacity();
+    }
+
+    void shrink_to_fit() {
+        v_values.shrink_to_fit();
+        v_zones.shrink_to_fit();
+    }
+
+    // Range queries
+    // Index of the first element at or after from with
+    // low <= element <= high, or npos.
+    [[nodiscard]] size_type
+    find_in_range(const T &low, const T &high, size_type from = 0) const {
+        for (size_type chunk = from / chunk_size; chunk < chunk_count();
+             ++chunk) {
+            const zone &bounds = zone_of(chunk);
+            if (bounds.max < low || high < bounds.min) {
+                continue;
+            }
+            const T *data = v_values.chunk_data(chunk);
+            const size_type n = v_values.chunk_length(chunk);
+            const size_type start = chunk * chunk_size;
+            for (size_type i = std::max(from, start) - start; i < n; ++i) {
+                if (in_range(data[i], low, high)) {
+                    return start + i;
+                }
+            }
+        }
+        return npos;
+    }
+
+    // Number of elements with low <= element <= high.
+    [[nodiscard]] size_type count_in_range(const T &low, const T &high) const {
+        size_type result = 0;
+        for (size_type chunk = 0; chunk < chunk_count(); ++chunk) {
+            const zone &bounds = zone_of(chunk);
+            if (bounds.max < low || high < bounds.min) {
+                continue;
+            }
+            const size_type n = v_values.chunk_length(chunk);
+            if (!bounds.has_nan && in_range(bounds.min, low, high) &&
+                in_range(bounds.max, low, high)) {
+                result += n;
+                continue;
+            }
+            const T *data = v_values.chunk_data(chunk);
+            for (size_type i = 0; i < n; ++i) {
+                result += in_range(data[i], low, high);
+            }
+        }
+        return result;
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        v_values.clear();
+        v_zones.clear();
+    }
+
+    void push_back(const T &value) {
+        emplace_back(value);
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args) {
+        // Room for the zone of a new chunk, grown geometrically.
+        const size_type zones = v_values.size() / chunk_size + 1;
+        if (v_zones.capacity() < zones) {
+            v_zones.reserve(std::max(2 * v_zones.capacity(), zones));
+        }
+        v_values.emplace_back(std::forward<Args>(args)...);
+        widen_back();
+        return v_values.back();
+    }
+
+    // Removing the minimum or maximum of a chunk leaves its zone dirty.
+    void pop_back() {
+        const T value = v_values.back();
+        v_values.pop_back();
+        if (v_zones.size() > v_values.chunk_count()) {
+            v_zones.pop_back();
+            return;
+        }
+        zone &last = v_zones.back();
+        if (!(last.min < value) || !(value < last.max)) {
+            last.dirty = true;
+        }
+    }
+
+    const_iterator insert(const_iterator pos, const T &value) {
+        const size_type index = pos - cbegin();
+        try {
+            v_values.insert(pos, value);
+        } catch (...) {
+            dirty_from(index);
+            throw;
+        }
+        dirty_from(index);
+        return cbegin() + index;
+    }
+
+    template <
+        class InputIt,
+        std::enable_if_t<
+            std::is_base_of_v<
+                std::input_iterator_tag,
+                typename std::iterator_traits<InputIt>::iterator_category>,
+            bool> = true>
+    const_iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        const size_type index = pos - cbegin();
+        try {
+            v_values.insert(pos, first, last);
+        } catch (...) {
+            dirty_from(index);
+            throw;
+        }
+        dirty_from(index);
+        return cbegin() + index;
+    }
+
+    const_iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    const_iterator erase(const_iterator first, const_iterator last) {
+        const size_type index = first - cbegin();
+        v_values.erase(first, last);
+        dirty_from(index);
+        return cbegin() + index;
+    }
+
+    void resize(size_type count, const T &value = T()) {
+        const size_type index = std::min(size(), count);
+        try {
+            v_values.resize(count, value);
+        } catch (...) {
+            dirty_from(index);
+            throw;
+        }
+        dirty_from(index);
+    }
+
+    void swap(zoned_chunk_vector &other) noexcept {
+        v_values.swap(other.v_values);
+        v_zones.swap(other.v_zones);
+    }
+};
+
+template <typename T, std::size_t chunk_size, typename Alloc>
+void swap(
+    zoned_chunk_vector<T, chunk_size, Alloc> &lhs,
+    zoned_chunk_vector<T, chunk_size, Alloc> &rhs
+) noexcept {
+    lhs.swap(rhs);
+}
+}  // namespace CustomVector
+
+#endif  // ZONED_CHUNK_VECTOR_HPP